@@ -1,6 +1,7 @@
 TEMPLATE = subdirs
 
 SUBDIRS = signal_slot \
+    signal_slot/benchmark \
     stringlistmodel \
     xmltreemodel \
     transform
@@ -0,0 +1,41 @@
+#include "atomic_counter.h"
+
+#include <QMetaObject>
+
+AtomicCounter::AtomicCounter(QObject* parent)
+    : QObject(parent)
+    , m_value(0)
+    , m_notifyPending(false)
+    , m_emitted(0)
+{}
+
+int AtomicCounter::value() const
+{
+    return m_value.load(std::memory_order_acquire);
+}
+
+void AtomicCounter::setValue(int value)
+{
+    // seq_cst pairs with store-then-load in notify(): either notify()
+    // reads this value or this exchange sees cleared flag
+    if (m_value.exchange(value, std::memory_order_seq_cst) == value)
+        return;
+    if (m_notifyPending.exchange(true, std::memory_order_seq_cst))
+        return;
+    QMetaObject::invokeMethod(this, [this] () -> void
+    {
+        notify();
+    }, Qt::QueuedConnection);
+}
+
+void AtomicCounter::notify()
+{
+    // clear flag before reading value, so any write
+    // made after reading will post new notification
+    m_notifyPending.store(false, std::memory_order_seq_cst);
+    int value = m_value.load(std::memory_order_seq_cst);
+    if (value == m_emitted)
+        return;
+    m_emitted = value;
+    emit valueChanged(value);
+}
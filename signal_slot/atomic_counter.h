@@ -0,0 +1,51 @@
+#ifndef ATOMIC_COUNTER_H
+#define ATOMIC_COUNTER_H
+
+#include <QObject>
+
+#include <atomic>
+
+/**
+ * @brief The AtomicCounter class
+ * is a Counter (see signal_slot.h) that can be set
+ * from any thread directly, without queued connection
+ * and event loop hop for every write.
+ * Value is stored in atomic variable, so writer only stores it
+ * and, if it's the first change since last notification, posts
+ * notification to thread the counter lives in. Notification emits
+ * valueChanged() with the latest value, so any number of writes
+ * between two iterations of event loop results in at most one
+ * valueChanged() emission (and at most one queued call
+ * for every observer).
+ * Note that posting event locks Qt's event queue for a moment,
+ * but only one writer per event loop iteration does it.
+ */
+class AtomicCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AtomicCounter(QObject* parent = NULL);
+
+    int value() const;
+
+public slots:
+    /**
+     * @brief setValue can be called from any thread.
+     * @param value
+     */
+    void setValue(int value);
+
+signals:
+    void valueChanged(int newValue);
+
+private:
+    void notify();
+
+    std::atomic<int> m_value;
+    std::atomic<bool> m_notifyPending;
+    // last emitted value, used only by owner thread
+    int m_emitted;
+};
+
+#endif // ATOMIC_COUNTER_H
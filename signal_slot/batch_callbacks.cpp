@@ -0,0 +1,79 @@
+#include "batch_callbacks.h"
+
+#include <cstring>
+
+int InputBatch::size() const
+{
+    return m_offsets.isEmpty() ? 0 : m_offsets.size() - 1;
+}
+
+bool InputBatch::isEmpty() const
+{
+    return size() == 0;
+}
+
+QStringRef InputBatch::at(int i) const
+{
+    return QStringRef(&m_buffer, m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+}
+
+const QString &InputBatch::buffer() const
+{
+    return m_buffer;
+}
+
+BatchCallback::~BatchCallback()
+{}
+
+BatchInputDataProvider::BatchInputDataProvider()
+    : m_callback(NULL)
+{}
+
+void BatchInputDataProvider::setCallback(BatchCallback* callback)
+{
+    m_callback = callback;
+}
+
+static QChar* appendChars(QChar* out, const QString &string)
+{
+    std::memcpy(out, string.constData(), string.size() * sizeof(QChar));
+    return out + string.size();
+}
+
+void BatchInputDataProvider::updateData(const NameRecord* first,
+                                        const NameRecord* last)
+{
+    int length = 0;
+    for (const NameRecord* record = first; record != last; ++record)
+        length += record->name.size() + 1 + record->surname.size();
+
+    // resize() keeps capacity of unshared buffer,
+    // so steady stream of batches doesn't allocate at all
+    m_batch.m_buffer.resize(length);
+    m_batch.m_offsets.resize(int(last - first) + 1);
+
+    QChar* begin = m_batch.m_buffer.data();
+    QChar* out = begin;
+    int* offset = m_batch.m_offsets.data();
+    for (const NameRecord* record = first; record != last; ++record)
+    {
+        *offset++ = int(out - begin);
+        out = appendChars(out, record->name);
+        *out++ = QLatin1Char(' ');
+        out = appendChars(out, record->surname);
+    }
+    *offset = int(out - begin);
+
+    if (m_callback != NULL && first != last)
+        m_callback->inputBatchReady(m_batch);
+}
+
+void BatchInputDataProvider::updateData(const QVector<NameRecord> &records)
+{
+    updateData(records.constData(), records.constData() + records.size());
+}
+
+const InputBatch &BatchInputDataProvider::batch() const
+{
+    return m_batch;
+}
@@ -0,0 +1,115 @@
+#ifndef BATCH_CALLBACKS_H
+#define BATCH_CALLBACKS_H
+
+#include <QString>
+#include <QStringRef>
+#include <QVector>
+
+class SignalSlotKoan;
+
+/**
+ * When provider imports millions of records, calling callback
+ * for every record means millions of virtual calls and
+ * millions of small strings allocated.
+ * Instead provider can build all results into one buffer
+ * and call callback once for the whole batch.
+ */
+
+/**
+ * @brief The NameRecord struct
+ * input for one record of batch.
+ */
+struct NameRecord
+{
+    NameRecord()
+    {}
+
+    NameRecord(QString name, QString surname)
+        : name(name)
+        , surname(surname)
+    {}
+
+    QString name;
+    QString surname;
+};
+
+/**
+ * @brief The InputBatch class
+ * results of batch packed into single string buffer.
+ * Records are only views into buffer, so batch
+ * is valid until next update of provider.
+ */
+class InputBatch
+{
+public:
+    /**
+     * @brief size
+     * @return number of records in batch.
+     */
+    int size() const;
+    bool isEmpty() const;
+    /**
+     * @brief at
+     * @param i
+     * @return view of i-th record.
+     */
+    QStringRef at(int i) const;
+    /**
+     * @brief buffer
+     * @return all records one after another.
+     */
+    const QString &buffer() const;
+
+private:
+    QString m_buffer;
+    // record i is [m_offsets[i], m_offsets[i + 1]) in m_buffer
+    QVector<int> m_offsets;
+
+    friend class BatchInputDataProvider;
+};
+
+/**
+ * @brief The BatchCallback class
+ * is callback that receives whole batches.
+ */
+class BatchCallback
+{
+public:
+    virtual ~BatchCallback();
+    virtual void inputBatchReady(const InputBatch &batch) = 0;
+};
+
+/**
+ * @brief The BatchInputDataProvider class
+ * same as InputDataProvider from callbacks.h,
+ * but processes many records at once.
+ */
+class BatchInputDataProvider
+{
+public:
+    BatchInputDataProvider();
+
+    void setCallback(BatchCallback* callback);
+    /**
+     * @brief updateData concatenates name and surname of
+     * every record in range [first, last) with space between.
+     * Results are written into one buffer, which is allocated
+     * once for the whole batch (and reused by next batches if
+     * nobody holds a copy of it). Then callback is called once.
+     * Empty batch doesn't call callback.
+     * @param first
+     * @param last
+     */
+    void updateData(const NameRecord* first, const NameRecord* last);
+    void updateData(const QVector<NameRecord> &records);
+
+    const InputBatch &batch() const;
+
+private:
+    InputBatch m_batch;
+    BatchCallback* m_callback;
+
+    friend class SignalSlotKoan;
+};
+
+#endif // BATCH_CALLBACKS_H
@@ -0,0 +1,30 @@
+QT += core
+QT -= gui
+QT += testlib
+
+CONFIG += c++11
+
+TARGET = signal_slot_benchmark
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ..
+
+SOURCES += signal_slot_benchmark.cpp \
+    ../callbacks.cpp \
+    ../delegate_callbacks.cpp \
+    ../message_bus.cpp \
+    ../signal_slot.cpp \
+    ../interned_string.cpp \
+    ../multi_callbacks.cpp
+
+HEADERS += \
+    ../callbacks.h \
+    ../message_bus.h \
+    ../signal_slot.h \
+    ../interned_string.h \
+    ../multi_callbacks.h \
+    ../delegate.h \
+    ../delegate_callbacks.h \
+    ../fast_signal.h
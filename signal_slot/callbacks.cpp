@@ -5,6 +5,8 @@ void InputDataReceiver::inputReady(QString data)
     /**
      * You received your data with callback, now
      * store it.
+     * data is your own copy, so you can move it
+     * to m_data with std::move().
      */
 }
 
@@ -22,6 +24,9 @@ void InputDataProvider::updateData(QString name, QString surname)
      * Concatirnate name + " " + surname,
      * store result and notify receiver if
      * callback != NULL
+     * Tip: name + " " + surname creates temporary string
+     * for every "+". Include <QStringBuilder> and use "%"
+     * instead, then result is allocated only once.
      */
 }
 
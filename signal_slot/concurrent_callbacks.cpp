@@ -0,0 +1,207 @@
+#include "concurrent_callbacks.h"
+
+#include <QStringBuilder>
+
+#include <thread>
+
+typedef std::lock_guard<std::mutex> guard;
+
+/**
+ * Hazard record is owned by one notifying thread while it's active.
+ * Records are deleted only with registry, so their number is equal
+ * to maximum number of simultaneous notifications.
+ * All atomic operations on records and snapshot pointer are
+ * sequentially consistent, as writer relies on the fact that
+ * either it sees reader's hazard pointer, or reader sees new snapshot.
+ */
+struct CallbackRegistry::HazardRecord
+{
+    std::atomic<bool> active;
+    std::atomic<const Snapshot*> pointer;
+    HazardRecord* next;
+};
+
+/**
+ * @brief The CallbackRegistry::HazardGuard class
+ * owns hazard record while it's alive.
+ */
+class CallbackRegistry::HazardGuard
+{
+public:
+    explicit HazardGuard(const CallbackRegistry* registry)
+        : m_record(acquire(registry->m_hazards))
+    {}
+
+    ~HazardGuard()
+    {
+        m_record->pointer.store(nullptr);
+        m_record->active.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief protect
+     * @param source
+     * @return snapshot that can't be deleted while guard is alive.
+     */
+    const Snapshot* protect(const std::atomic<Snapshot*> &source)
+    {
+        const Snapshot* pointer = source.load();
+        for (;;)
+        {
+            m_record->pointer.store(pointer);
+            // snapshot could be replaced (and deleted) before
+            // we marked it, so check it once more.
+            const Snapshot* current = source.load();
+            if (current == pointer)
+                return pointer;
+            pointer = current;
+        }
+    }
+
+private:
+    static HazardRecord* acquire(std::atomic<HazardRecord*> &records)
+    {
+        for (HazardRecord* record = records.load(); record != nullptr;
+             record = record->next)
+        {
+            bool expected = false;
+            if (!record->active.load(std::memory_order_relaxed)
+                    && record->active.compare_exchange_strong(expected, true))
+                return record;
+        }
+
+        HazardRecord* record = new HazardRecord;
+        record->active.store(true);
+        record->pointer.store(nullptr);
+        HazardRecord* head = records.load();
+        do
+        {
+            record->next = head;
+        }
+        while (!records.compare_exchange_weak(head, record));
+        return record;
+    }
+
+    HazardRecord* m_record;
+};
+
+CallbackRegistry::CallbackRegistry()
+    : m_snapshot(new Snapshot())
+    , m_hazards(nullptr)
+{}
+
+CallbackRegistry::~CallbackRegistry()
+{
+    delete m_snapshot.load();
+    HazardRecord* record = m_hazards.load();
+    while (record != nullptr)
+    {
+        HazardRecord* next = record->next;
+        delete record;
+        record = next;
+    }
+}
+
+void CallbackRegistry::addCallback(Callback* callback)
+{
+    if (callback == NULL)
+        return;
+    Snapshot* old;
+    {
+        guard g(m_writeMutex);
+        const Snapshot* current = m_snapshot.load();
+        if (current->callbacks.contains(callback))
+            return;
+        Snapshot* snapshot = new Snapshot(*current);
+        snapshot->callbacks.append(callback);
+        old = m_snapshot.exchange(snapshot);
+    }
+    retire(old);
+}
+
+void CallbackRegistry::removeCallback(Callback* callback)
+{
+    Snapshot* old = NULL;
+    {
+        guard g(m_writeMutex);
+        const Snapshot* current = m_snapshot.load();
+        int i = current->callbacks.indexOf(callback);
+        if (i >= 0)
+        {
+            Snapshot* snapshot = new Snapshot(*current);
+            snapshot->callbacks.remove(i);
+            old = m_snapshot.exchange(snapshot);
+        }
+    }
+    if (old == NULL)
+    {
+        // callback could be removed by another thread that still
+        // waits for readers of old snapshots, caller may delete
+        // callback only after they are done
+        waitForReaders();
+        return;
+    }
+    retire(old);
+}
+
+void CallbackRegistry::retire(Snapshot* old)
+{
+    waitForReaders();
+    delete old;
+}
+
+void CallbackRegistry::waitForReaders() const
+{
+    // Wait for every notification that uses any snapshot except
+    // the latest one. Waiting only for "old" isn't enough, as some
+    // slow thread can still use even older snapshot with the same
+    // callback in it. It's done without holding m_writeMutex.
+    for (;;)
+    {
+        bool busy = false;
+        for (HazardRecord* record = m_hazards.load(); record != nullptr;
+             record = record->next)
+        {
+            const Snapshot* pointer = record->pointer.load();
+            if (pointer != nullptr && pointer != m_snapshot.load())
+            {
+                busy = true;
+                break;
+            }
+        }
+        if (!busy)
+            break;
+        std::this_thread::yield();
+    }
+}
+
+void CallbackRegistry::notify(const QString &data) const
+{
+    HazardGuard hazard(this);
+    const Snapshot* snapshot = hazard.protect(m_snapshot);
+    Callback* const* callback = snapshot->callbacks.constData();
+    Callback* const* end = callback + snapshot->callbacks.size();
+    for (; callback != end; ++callback)
+        (*callback)->inputReady(data);
+}
+
+int CallbackRegistry::size() const
+{
+    HazardGuard hazard(this);
+    return hazard.protect(m_snapshot)->callbacks.size();
+}
+
+void ConcurrentInputDataProvider::setCallback(Callback* callback)
+{
+    m_callbacks.addCallback(callback);
+}
+
+void ConcurrentInputDataProvider::removeCallback(Callback* callback)
+{
+    m_callbacks.removeCallback(callback);
+}
+
+void ConcurrentInputDataProvider::updateData(QString name, QString surname)
+{
+    m_callbacks.notify(name % QLatin1Char(' ') % surname);
+}
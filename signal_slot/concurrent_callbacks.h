@@ -0,0 +1,114 @@
+#ifndef CONCURRENT_CALLBACKS_H
+#define CONCURRENT_CALLBACKS_H
+
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <mutex>
+
+#include "callbacks.h"
+
+/**
+ * Pitfall #2 from callbacks.h says that direct callbacks called
+ * from one thread while receiver is deleted in another require
+ * synchronization primitives. Here is how it can be done without
+ * locking every notification.
+ * Registry keeps immutable snapshot of callbacks array.
+ * Adding or removing callback creates new snapshot and publishes it
+ * atomically. Notifying thread marks snapshot it reads with
+ * a hazard pointer. Writer waits until no thread uses any snapshot
+ * but the latest one before deleting old snapshot (or returning
+ * from removeCallback()), as older snapshots could still contain
+ * removed callback. So notification path takes no locks at all, and
+ * writers (which are rare) wait for readers.
+ */
+
+/**
+ * @brief The CallbackRegistry class
+ * thread safe list of callbacks.
+ */
+class CallbackRegistry
+{
+public:
+    CallbackRegistry();
+    /**
+     * Registry must not be used by other threads when deleted.
+     */
+    ~CallbackRegistry();
+
+    /**
+     * @brief addCallback registers callback,
+     * already registered callback is ignored.
+     * @param callback
+     */
+    void addCallback(Callback* callback);
+    /**
+     * @brief removeCallback unregisters callback.
+     * When function returns callback is guaranteed
+     * not to be called anymore from any thread, so it's
+     * safe to delete it. That holds even if callback
+     * isn't registered, as another thread could have just removed it.
+     * Must not be called from inside of callback
+     * invoked by this registry, as it will wait forever.
+     * @param callback
+     */
+    void removeCallback(Callback* callback);
+    /**
+     * @brief notify calls every registered callback.
+     * Lock free, can be called from any number of threads.
+     * @param data
+     */
+    void notify(const QString &data) const;
+    /**
+     * @brief size
+     * @return number of registered callbacks.
+     */
+    int size() const;
+
+private:
+    Q_DISABLE_COPY(CallbackRegistry)
+
+    struct Snapshot
+    {
+        QVector<Callback*> callbacks;
+    };
+    struct HazardRecord;
+    class HazardGuard;
+
+    void retire(Snapshot* old);
+    void waitForReaders() const;
+
+    std::atomic<Snapshot*> m_snapshot;
+    mutable std::atomic<HazardRecord*> m_hazards;
+    std::mutex m_writeMutex;
+};
+
+/**
+ * @brief The ConcurrentInputDataProvider class
+ * sends input data to multiple callbacks,
+ * updateData() may be called from any thread and
+ * callbacks may be removed from any other thread.
+ * Works with InputDataReceiver2 as well, as it implements
+ * ProviderInterface.
+ */
+class ConcurrentInputDataProvider : public ProviderInterface
+{
+public:
+    void setCallback(Callback* callback);
+    void removeCallback(Callback* callback);
+    /**
+     * @brief updateData concatenates name and surname
+     * with space between and notifies every callback.
+     * Note that there is no m_data member, as
+     * multiple threads can update data simultaneously.
+     * @param name
+     * @param surname
+     */
+    void updateData(QString name, QString surname);
+
+private:
+    CallbackRegistry m_callbacks;
+};
+
+#endif // CONCURRENT_CALLBACKS_H
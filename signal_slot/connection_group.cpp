@@ -0,0 +1,182 @@
+#include "connection_group.h"
+
+#include "signal_slot.h"
+
+ConnectionGroup::ConnectionGroup()
+{}
+
+ConnectionGroup::~ConnectionGroup()
+{
+    disconnectAll();
+}
+
+void ConnectionGroup::reserve(int count)
+{
+    m_entries.reserve(count);
+    m_index.reserve(count);
+}
+
+bool ConnectionGroup::connect(Counter* sender, Counter* receiver)
+{
+    const Link link(sender, receiver);
+    auto i = m_index.find(link);
+    if (i != m_index.end())
+    {
+        // connection could be broken by QObject::disconnect()
+        // outside of group
+        Entry &entry = m_entries[i.value()];
+        if (entry.connection)
+            return false;
+        entry.connection = QObject::connect(sender, &Counter::valueChanged,
+                                            receiver, &Counter::setValue);
+        return true;
+    }
+    Entry entry;
+    entry.link = link;
+    entry.connection = QObject::connect(sender, &Counter::valueChanged,
+                                        receiver, &Counter::setValue);
+    entry.senderSlot = watch(sender, link);
+    entry.receiverSlot = watch(receiver, link);
+    m_index.insert(link, m_entries.size());
+    m_entries.append(entry);
+    return true;
+}
+
+int ConnectionGroup::connect(Counter* sender, const QVector<Counter*> &receivers)
+{
+    reserve(m_entries.size() + receivers.size());
+    int connected = 0;
+    for (Counter* receiver : receivers)
+    {
+        if (connect(sender, receiver))
+            ++connected;
+    }
+    return connected;
+}
+
+int ConnectionGroup::connect(const QVector<Counter*> &senders, Counter* receiver)
+{
+    reserve(m_entries.size() + senders.size());
+    int connected = 0;
+    for (Counter* sender : senders)
+    {
+        if (connect(sender, receiver))
+            ++connected;
+    }
+    return connected;
+}
+
+bool ConnectionGroup::contains(Counter* sender, Counter* receiver) const
+{
+    auto i = m_index.constFind(Link(sender, receiver));
+    return i != m_index.constEnd() && bool(m_entries.at(i.value()).connection);
+}
+
+bool ConnectionGroup::disconnect(Counter* sender, Counter* receiver)
+{
+    QMetaObject::Connection connection;
+    if (!removeEntry(Link(sender, receiver), &connection))
+        return false;
+    return QObject::disconnect(connection);
+}
+
+void ConnectionGroup::disconnectAll()
+{
+    for (const Entry &entry : m_entries)
+        QObject::disconnect(entry.connection);
+    for (const Watch &watch : m_watches)
+        QObject::disconnect(watch.destroyed);
+    m_entries.clear();
+    m_index.clear();
+    m_watches.clear();
+}
+
+int ConnectionGroup::size() const
+{
+    return m_entries.size();
+}
+
+int ConnectionGroup::watch(Counter* counter, const Link &link)
+{
+    auto i = m_watches.find(counter);
+    if (i == m_watches.end())
+    {
+        Watch watch;
+        watch.destroyed = QObject::connect(counter, &QObject::destroyed,
+                                           [this, counter] () -> void
+        {
+            forget(counter);
+        });
+        i = m_watches.insert(counter, watch);
+    }
+    i.value().links.append(link);
+    return i.value().links.size() - 1;
+}
+
+void ConnectionGroup::unwatch(const Counter* counter, int slot)
+{
+    auto i = m_watches.find(counter);
+    // watch of destroyed Counter is already taken by forget()
+    if (i == m_watches.end())
+        return;
+    QVector<Link> &links = i.value().links;
+    const int last = links.size() - 1;
+    if (slot != last)
+    {
+        // fix slot of moved link, for link of Counter to itself
+        // both slots are in this watch, so compare slot too
+        links[slot] = links.at(last);
+        Entry &moved = m_entries[m_index.value(links.at(slot))];
+        if (moved.link.first == counter && moved.senderSlot == last)
+            moved.senderSlot = slot;
+        else
+            moved.receiverSlot = slot;
+    }
+    links.removeLast();
+    if (links.isEmpty())
+    {
+        QObject::disconnect(i.value().destroyed);
+        m_watches.erase(i);
+    }
+}
+
+void ConnectionGroup::forget(const Counter* counter)
+{
+    // Qt removes connections of destroyed object itself
+    const Watch watch = m_watches.take(counter);
+    for (const Link &link : watch.links)
+        removeEntry(link, NULL);
+}
+
+bool ConnectionGroup::removeEntry(const Link &link,
+                                  QMetaObject::Connection* connection)
+{
+    auto i = m_index.find(link);
+    if (i == m_index.end())
+        return false;
+    const int index = i.value();
+    m_index.erase(i);
+    const Entry entry = m_entries.at(index);
+    if (connection != NULL)
+        *connection = entry.connection;
+    // for link of Counter to itself both slots are in one watch,
+    // higher one goes first, so lower one isn't moved
+    if (link.first == link.second && entry.senderSlot > entry.receiverSlot)
+    {
+        unwatch(link.first, entry.senderSlot);
+        unwatch(link.second, entry.receiverSlot);
+    }
+    else
+    {
+        unwatch(link.second, entry.receiverSlot);
+        unwatch(link.first, entry.senderSlot);
+    }
+    const int last = m_entries.size() - 1;
+    if (index != last)
+    {
+        m_entries[index] = m_entries.at(last);
+        m_index[m_entries.at(index).link] = index;
+    }
+    m_entries.removeLast();
+    return true;
+}
@@ -0,0 +1,110 @@
+#ifndef CONNECTION_GROUP_H
+#define CONNECTION_GROUP_H
+
+#include <QHash>
+#include <QMetaObject>
+#include <QPair>
+#include <QVector>
+
+class Counter;
+
+/**
+ * connectExample2() and connectExample3() make few connections,
+ * but when one Counter is connected to 100k receivers, every
+ * connect() with Qt::UniqueConnection walks all existing connections
+ * of sender looking for duplicate, so connecting takes quadratic time.
+ * ConnectionGroup remembers links it made in hash, so duplicate check
+ * is one lookup, and keeps all connections in one array, so they can
+ * be torn down in one pass.
+ */
+
+/**
+ * @brief The ConnectionGroup class
+ * owns Counter::valueChanged -> Counter::setValue connections,
+ * all of them are disconnected when group is destroyed.
+ * Connections of destroyed Counters are dropped from group.
+ * Group and its Counters must live in one thread.
+ */
+class ConnectionGroup
+{
+public:
+    ConnectionGroup();
+    ~ConnectionGroup();
+
+    /**
+     * @brief reserve space for count connections.
+     * @param count
+     */
+    void reserve(int count);
+
+    /**
+     * @brief connect same as connectExample().
+     * @param sender
+     * @param receiver
+     * @return false if group already has such connection.
+     */
+    bool connect(Counter* sender, Counter* receiver);
+    /**
+     * @brief connect fan-out, sender to every receiver.
+     * @param sender
+     * @param receivers
+     * @return number of connections made.
+     */
+    int connect(Counter* sender, const QVector<Counter*> &receivers);
+    /**
+     * @brief connect fan-in, every sender to receiver.
+     * @param senders
+     * @param receiver
+     * @return number of connections made.
+     */
+    int connect(const QVector<Counter*> &senders, Counter* receiver);
+
+    bool contains(Counter* sender, Counter* receiver) const;
+    bool disconnect(Counter* sender, Counter* receiver);
+    /**
+     * @brief disconnectAll in O(n) of connections in group.
+     */
+    void disconnectAll();
+
+    int size() const;
+
+private:
+    ConnectionGroup(const ConnectionGroup &) = delete;
+    ConnectionGroup &operator=(const ConnectionGroup &) = delete;
+
+    typedef QPair<const Counter*, const Counter*> Link;
+
+    struct Entry
+    {
+        Link link;
+        QMetaObject::Connection connection;
+        // index of link in Watch::links of sender and of receiver
+        int senderSlot;
+        int receiverSlot;
+    };
+
+    /**
+     * Links of Counter, so they can be dropped when it's destroyed.
+     * Watch is removed with its last link, so churn of connections
+     * doesn't leave anything behind.
+     */
+    struct Watch
+    {
+        QMetaObject::Connection destroyed;
+        // unordered, removal moves last one in place of removed
+        QVector<Link> links;
+    };
+
+    int watch(Counter* counter, const Link &link);
+    void unwatch(const Counter* counter, int slot);
+    void forget(const Counter* counter);
+    bool removeEntry(const Link &link, QMetaObject::Connection* connection);
+
+    // entries are unordered, removal moves last one in place of removed
+    QVector<Entry> m_entries;
+    // link -> index in m_entries
+    QHash<Link, int> m_index;
+    QHash<const Counter*, Watch> m_watches;
+};
+
+#endif // CONNECTION_GROUP_H
@@ -0,0 +1,97 @@
+#include "counter_array.h"
+
+CounterArray::CounterArray(int size, QObject* parent)
+    : QObject(parent)
+    , m_values(size, 0)
+    , m_updateDepth(0)
+    , m_changedFirst(-1)
+    , m_changedLast(-1)
+{}
+
+int CounterArray::size() const
+{
+    return m_values.size();
+}
+
+void CounterArray::resize(int size)
+{
+    m_values.resize(size);
+    if (m_changedFirst >= size)
+    {
+        m_changedFirst = -1;
+        m_changedLast = -1;
+    }
+    else if (m_changedLast >= size)
+        m_changedLast = size - 1;
+}
+
+int CounterArray::value(int index) const
+{
+    return m_values.at(index);
+}
+
+const int* CounterArray::constData() const
+{
+    return m_values.constData();
+}
+
+void CounterArray::beginUpdate()
+{
+    ++m_updateDepth;
+}
+
+void CounterArray::endUpdate()
+{
+    Q_ASSERT(m_updateDepth > 0);
+    if (--m_updateDepth == 0)
+        flush();
+}
+
+void CounterArray::setValue(int index, int value)
+{
+    Q_ASSERT(index >= 0 && index < m_values.size());
+    if (m_values.at(index) == value)
+        return;
+    m_values[index] = value;
+    markChanged(index, index);
+}
+
+void CounterArray::setValues(int first, const int* values, int count)
+{
+    Q_ASSERT(first >= 0 && count >= 0 && first + count <= m_values.size());
+    int* data = m_values.data() + first;
+    int changedFirst = -1;
+    int changedLast = -1;
+    for (int i = 0; i < count; ++i)
+    {
+        if (data[i] == values[i])
+            continue;
+        data[i] = values[i];
+        if (changedFirst < 0)
+            changedFirst = i;
+        changedLast = i;
+    }
+    if (changedFirst >= 0)
+        markChanged(first + changedFirst, first + changedLast);
+}
+
+void CounterArray::markChanged(int first, int last)
+{
+    if (m_changedFirst < 0 || first < m_changedFirst)
+        m_changedFirst = first;
+    if (last > m_changedLast)
+        m_changedLast = last;
+    if (m_updateDepth == 0)
+        flush();
+}
+
+void CounterArray::flush()
+{
+    if (m_changedFirst < 0)
+        return;
+    int first = m_changedFirst;
+    int last = m_changedLast;
+    m_changedFirst = -1;
+    m_changedLast = -1;
+    emit valuesChanged(first, last);
+}
@@ -0,0 +1,87 @@
+#ifndef COUNTER_ARRAY_H
+#define COUNTER_ARRAY_H
+
+#include <QObject>
+#include <QVector>
+
+/**
+ * Thousands of Counters updated one setValue() at a time emit
+ * thousands of valueChanged(int) signals, and every emission
+ * means looking up connections and calling each slot separately.
+ * When values change together, it's better to keep them
+ * in one contiguous array and to notify about the whole range
+ * at once. Listener then walks plain memory (see constData())
+ * instead of handling one signal per element.
+ */
+
+/**
+ * @brief The CounterArray class
+ * stores many counter values contiguously.
+ * Changes made between beginUpdate() and endUpdate()
+ * are reported by single valuesChanged() signal.
+ */
+class CounterArray : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CounterArray(int size = 0, QObject* parent = NULL);
+
+    int size() const;
+    /**
+     * @brief resize new values are 0,
+     * doesn't emit valuesChanged().
+     * @param size
+     */
+    void resize(int size);
+
+    int value(int index) const;
+    /**
+     * @brief constData pointer to size() values,
+     * invalidated by resize().
+     * @return
+     */
+    const int* constData() const;
+
+    /**
+     * @brief beginUpdate starts batch, batches can be nested,
+     * signal is emitted by outermost endUpdate().
+     */
+    void beginUpdate();
+    void endUpdate();
+
+    /**
+     * @brief setValue outside of batch emits valuesChanged(index, index)
+     * if value differs from current one.
+     * @param index
+     * @param value
+     */
+    void setValue(int index, int value);
+    /**
+     * @brief setValues copies count values starting at first,
+     * emits at most one valuesChanged() covering changed values.
+     * @param first
+     * @param values
+     * @param count
+     */
+    void setValues(int first, const int* values, int count);
+
+signals:
+    /**
+     * @brief valuesChanged range of changed values, both ends inclusive.
+     * Range may contain values that didn't change
+     * between the first and the last changed ones.
+     */
+    void valuesChanged(int first, int last);
+
+private:
+    void markChanged(int first, int last);
+    void flush();
+
+    QVector<int> m_values;
+    int m_updateDepth;
+    int m_changedFirst;
+    int m_changedLast;
+};
+
+#endif // COUNTER_ARRAY_H
@@ -0,0 +1,188 @@
+#include "counter_graph.h"
+
+#include <QSet>
+
+CounterGraph::CounterGraph(QObject* parent)
+    : QObject(parent)
+    , m_depth(0)
+{}
+
+CounterGraph::Node &CounterGraph::node(Counter* counter)
+{
+    auto i = m_nodes.find(counter);
+    if (i == m_nodes.end())
+    {
+        i = m_nodes.insert(counter, Node());
+        QObject::connect(counter, &QObject::destroyed, this,
+                         [this] (QObject* object) -> void
+        {
+            removeCounter(object);
+        });
+    }
+    return i.value();
+}
+
+bool CounterGraph::connect(Counter* sender, Counter* receiver)
+{
+    if (sender == receiver || reaches(receiver, sender))
+        return false;
+    Node &senderNode = node(sender);
+    if (senderNode.receivers.contains(receiver))
+        return false;
+    senderNode.receivers.append(receiver);
+    node(receiver).senders.append(sender);
+    return true;
+}
+
+bool CounterGraph::disconnect(Counter* sender, Counter* receiver)
+{
+    auto i = m_nodes.find(sender);
+    if (i == m_nodes.end() || !i.value().receivers.removeOne(receiver))
+        return false;
+    m_nodes[receiver].senders.removeOne(sender);
+    return true;
+}
+
+bool CounterGraph::reaches(Counter* from, Counter* to) const
+{
+    QVector<Counter*> stack;
+    QSet<Counter*> visited;
+    stack.append(from);
+    while (!stack.isEmpty())
+    {
+        Counter* counter = stack.takeLast();
+        if (counter == to)
+            return true;
+        if (visited.contains(counter))
+            continue;
+        visited.insert(counter);
+        auto i = m_nodes.constFind(counter);
+        if (i != m_nodes.constEnd())
+            stack += i.value().receivers;
+    }
+    return false;
+}
+
+void CounterGraph::removeCounter(QObject* object)
+{
+    // object is already destroyed, it's only used as a key
+    Counter* counter = static_cast<Counter*>(object);
+    m_nodes.remove(counter);
+    m_pending.remove(counter);
+    m_lastChanges.remove(counter);
+    m_lastOrder.removeAll(counter);
+    for (Node &node : m_nodes)
+    {
+        node.receivers.removeAll(counter);
+        node.senders.removeAll(counter);
+    }
+}
+
+void CounterGraph::beginTransaction()
+{
+    ++m_depth;
+}
+
+void CounterGraph::setValue(Counter* counter, int value)
+{
+    node(counter);
+    m_pending.insert(counter, value);
+    if (m_depth == 0)
+    {
+        beginTransaction();
+        commit();
+    }
+}
+
+void CounterGraph::commit()
+{
+    if (m_depth == 0 || --m_depth > 0)
+        return;
+
+    // collect counters affected by transaction
+    // and number of affected senders of every one of them
+    QHash<Counter*, int> senders;
+    QVector<Counter*> stack;
+    for (auto i = m_pending.constBegin(); i != m_pending.constEnd(); ++i)
+    {
+        senders.insert(i.key(), 0);
+        stack.append(i.key());
+    }
+    QSet<Counter*> visited;
+    while (!stack.isEmpty())
+    {
+        Counter* counter = stack.takeLast();
+        if (visited.contains(counter))
+            continue;
+        visited.insert(counter);
+        for (Counter* receiver : m_nodes.value(counter).receivers)
+        {
+            ++senders[receiver];
+            stack.append(receiver);
+        }
+    }
+
+    // Kahn's algorithm: counter is evaluated when
+    // all its affected senders are evaluated
+    struct Value
+    {
+        int value;
+        // -1 for value set directly
+        int priority;
+    };
+    QHash<Counter*, Value> values;
+    for (auto i = m_pending.constBegin(); i != m_pending.constEnd(); ++i)
+    {
+        Value value = { i.value(), -1 };
+        values.insert(i.key(), value);
+    }
+    m_pending.clear();
+    m_lastOrder.clear();
+    m_lastChanges.clear();
+    QVector<Counter*> ready;
+    for (auto i = senders.constBegin(); i != senders.constEnd(); ++i)
+    {
+        if (i.value() == 0)
+            ready.append(i.key());
+    }
+    while (!ready.isEmpty())
+    {
+        Counter* counter = ready.takeLast();
+        m_lastOrder.append(counter);
+
+        auto i = values.constFind(counter);
+        bool changed = i != values.constEnd() && counter->value() != i.value().value;
+        int value = changed ? i.value().value : 0;
+        if (changed)
+        {
+            m_lastChanges.insert(counter, value);
+            counter->setValue(value);
+        }
+
+        for (Counter* receiver : m_nodes.value(counter).receivers)
+        {
+            if (changed)
+            {
+                const int priority = m_nodes.value(receiver).senders.indexOf(counter);
+                auto current = values.find(receiver);
+                if (current == values.end() || current.value().priority < priority)
+                {
+                    Value received = { value, priority };
+                    values.insert(receiver, received);
+                }
+            }
+            if (--senders[receiver] == 0)
+                ready.append(receiver);
+        }
+    }
+}
+
+QVector<Counter*> CounterGraph::lastEvaluationOrder() const
+{
+    return m_lastOrder;
+}
+
+QHash<Counter*, int> CounterGraph::lastChanges() const
+{
+    return m_lastChanges;
+}
@@ -0,0 +1,102 @@
+#ifndef COUNTER_GRAPH_H
+#define COUNTER_GRAPH_H
+
+#include <QHash>
+#include <QObject>
+#include <QVector>
+
+#include "signal_slot.h"
+
+/**
+ * When Counters are connected with QObject::connect() into chains
+ * and diamonds (A -> B, A -> C, B -> D, C -> D), one setValue() on A
+ * makes D receive value twice, and with longer chains number of
+ * re-emissions grows with number of paths. Cycle (A -> B -> A) stops
+ * only because setValue() ignores equal values.
+ * CounterGraph is an alternative to such connections: it knows the
+ * whole graph, so it can collect all changes made in transaction,
+ * sort affected Counters topologically and call setValue() for every
+ * Counter exactly once. Cycles are rejected when connecting.
+ */
+
+/**
+ * @brief The CounterGraph class
+ * propagates values along its connections in transactions.
+ * Counters are removed from graph automatically when destroyed.
+ */
+class CounterGraph : public QObject
+{
+public:
+    explicit CounterGraph(QObject* parent = NULL);
+
+    /**
+     * @brief connect makes receiver follow value of sender
+     * (same as connectExample() from signal_slot.h).
+     * @param sender
+     * @param receiver
+     * @return false if connection exists or would create a cycle.
+     */
+    bool connect(Counter* sender, Counter* receiver);
+    /**
+     * @brief disconnect
+     * @param sender
+     * @param receiver
+     * @return false if there was no such connection.
+     */
+    bool disconnect(Counter* sender, Counter* receiver);
+
+    /**
+     * @brief beginTransaction starts collecting changes,
+     * transactions can be nested, changes are applied
+     * by outermost commit().
+     */
+    void beginTransaction();
+    /**
+     * @brief commit applies all values set during transaction.
+     * Every Counter affected by transaction is evaluated once,
+     * after all Counters it depends on. If Counter was set directly
+     * and also receives value from changed sender, value from sender wins.
+     * If several of its senders changed, value comes from the one
+     * that was connected to it last (later connect() has higher
+     * priority), so result doesn't depend on evaluation order.
+     */
+    void commit();
+    /**
+     * @brief setValue sets value of counter, outside of
+     * transaction it's applied immediately (as one-value transaction).
+     * @param counter
+     * @param value
+     */
+    void setValue(Counter* counter, int value);
+
+    /**
+     * @brief lastEvaluationOrder
+     * @return Counters evaluated by the last commit, in order.
+     */
+    QVector<Counter*> lastEvaluationOrder() const;
+    /**
+     * @brief lastChanges
+     * @return values passed to setValue() of Counters by the last commit.
+     */
+    QHash<Counter*, int> lastChanges() const;
+
+private:
+    struct Node
+    {
+        QVector<Counter*> receivers;
+        // in order of connection, index is priority
+        QVector<Counter*> senders;
+    };
+
+    Node &node(Counter* counter);
+    bool reaches(Counter* from, Counter* to) const;
+    void removeCounter(QObject* counter);
+
+    QHash<Counter*, Node> m_nodes;
+    QHash<Counter*, int> m_pending;
+    QVector<Counter*> m_lastOrder;
+    QHash<Counter*, int> m_lastChanges;
+    int m_depth;
+};
+
+#endif // COUNTER_GRAPH_H
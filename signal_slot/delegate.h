@@ -0,0 +1,181 @@
+#ifndef DELEGATE_H
+#define DELEGATE_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Callback class from callbacks.h forces every receiver to inherit
+ * from it, and every call goes through virtual function, which compiler
+ * can't inline. Delegate is an alternative: it's a small object
+ * that stores pointer to receiver (or small functor itself) and
+ * pointer to a stub function generated for exact type of receiver.
+ * Inside of the stub call to receiver is direct, so it can be inlined.
+ * Delegate never allocates memory and can be copied as two pointers.
+ */
+
+template <class Signature>
+class Delegate;
+
+/**
+ * @brief The Delegate class
+ * non owning reference to free function, method or functor.
+ * Usage:
+ * Delegate<void(int)>::fromFunction<&function>();
+ * Delegate<void(int)>::fromMethod<Receiver, &Receiver::method>(&receiver);
+ * Delegate<void(int)>::fromFunctor([] (int value) -> void { ... });
+ * Delegate<void(int)>::fromReference(functor);
+ * Object that method or referenced functor belongs to must outlive delegate.
+ */
+template <class R, class... Args>
+class Delegate<R(Args...)>
+{
+public:
+    /**
+     * @brief BufferSize maximum size of functor stored inside of delegate.
+     */
+    enum { BufferSize = 2 * sizeof(void*) };
+
+    /**
+     * @brief Delegate creates null delegate,
+     * calling it is undefined behaviour.
+     */
+    Delegate()
+        : m_stub(NULL)
+    {}
+
+    template <R (*Function)(Args...)>
+    static Delegate fromFunction()
+    {
+        Delegate delegate;
+        delegate.m_stub = &functionStub<Function>;
+        return delegate;
+    }
+
+    template <class T, R (T::*Method)(Args...)>
+    static Delegate fromMethod(T* object)
+    {
+        Delegate delegate;
+        delegate.store(object);
+        delegate.m_stub = &methodStub<T, Method>;
+        return delegate;
+    }
+
+    template <class T, R (T::*Method)(Args...) const>
+    static Delegate fromMethod(const T* object)
+    {
+        Delegate delegate;
+        delegate.store(object);
+        delegate.m_stub = &constMethodStub<T, Method>;
+        return delegate;
+    }
+
+    /**
+     * @brief fromFunctor copies small trivially copyable
+     * functor (ex. lambda that captures a couple of pointers)
+     * inside of delegate.
+     * @param functor
+     * @return
+     */
+    template <class F>
+    static Delegate fromFunctor(F functor)
+    {
+        static_assert(sizeof(F) <= BufferSize
+                      && alignof(F) <= alignof(Storage),
+                      "functor is too big to be stored in Delegate, "
+                      "use fromReference()");
+        static_assert(std::is_trivially_copyable<F>::value,
+                      "functor must be trivially copyable, "
+                      "use fromReference()");
+        Delegate delegate;
+        new (&delegate.m_storage) F(functor);
+        delegate.m_stub = &functorStub<F>;
+        return delegate;
+    }
+
+    /**
+     * @brief fromReference references functor of any size,
+     * functor must outlive delegate.
+     * @param functor
+     * @return
+     */
+    template <class F>
+    static Delegate fromReference(F &functor)
+    {
+        Delegate delegate;
+        delegate.store(&functor);
+        delegate.m_stub = &referenceStub<F>;
+        return delegate;
+    }
+
+    bool isNull() const
+    {
+        return m_stub == NULL;
+    }
+
+    explicit operator bool() const
+    {
+        return m_stub != NULL;
+    }
+
+    R operator()(Args... args) const
+    {
+        return m_stub(&m_storage, std::forward<Args>(args)...);
+    }
+
+private:
+    typedef typename std::aligned_storage<BufferSize, alignof(void*)>::type Storage;
+    typedef R (*Stub)(const Storage* storage, Args... args);
+
+    template <class T>
+    void store(T* pointer)
+    {
+        new (&m_storage) T*(pointer);
+    }
+
+    template <class T>
+    static T* load(const Storage* storage)
+    {
+        return *reinterpret_cast<T* const*>(storage);
+    }
+
+    template <R (*Function)(Args...)>
+    static R functionStub(const Storage*, Args... args)
+    {
+        return Function(std::forward<Args>(args)...);
+    }
+
+    template <class T, R (T::*Method)(Args...)>
+    static R methodStub(const Storage* storage, Args... args)
+    {
+        return (load<T>(storage)->*Method)(std::forward<Args>(args)...);
+    }
+
+    template <class T, R (T::*Method)(Args...) const>
+    static R constMethodStub(const Storage* storage, Args... args)
+    {
+        return (load<const T>(storage)->*Method)(std::forward<Args>(args)...);
+    }
+
+    template <class F>
+    static R functorStub(const Storage* storage, Args... args)
+    {
+        // functor is called like std::function does: operator() of
+        // delegate is const, but stored functor may be mutable.
+        F* functor = reinterpret_cast<F*>(const_cast<Storage*>(storage));
+        return (*functor)(std::forward<Args>(args)...);
+    }
+
+    template <class F>
+    static R referenceStub(const Storage* storage, Args... args)
+    {
+        return (*load<F>(storage))(std::forward<Args>(args)...);
+    }
+
+    Storage m_storage;
+    Stub m_stub;
+};
+
+#endif // DELEGATE_H
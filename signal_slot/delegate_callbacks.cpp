@@ -0,0 +1,15 @@
+#include "delegate_callbacks.h"
+
+#include <QStringBuilder>
+
+void DelegateInputDataProvider::setCallback(InputDelegate callback)
+{
+    m_callback = callback;
+}
+
+void DelegateInputDataProvider::updateData(QString name, QString surname)
+{
+    m_data = name % QLatin1Char(' ') % surname;
+    if (m_callback)
+        m_callback(m_data);
+}
@@ -0,0 +1,47 @@
+#ifndef DELEGATE_CALLBACKS_H
+#define DELEGATE_CALLBACKS_H
+
+#include <QString>
+
+#include "delegate.h"
+
+class SignalSlotKoan;
+
+/**
+ * @brief InputDelegate callback that receives input data.
+ */
+typedef Delegate<void(const QString &)> InputDelegate;
+
+/**
+ * @brief The DelegateInputDataProvider class
+ * same as InputDataProvider from callbacks.h, but
+ * receiver doesn't need to inherit from Callback,
+ * any function, method or lambda with matching signature
+ * can be a callback.
+ */
+class DelegateInputDataProvider
+{
+public:
+    /**
+     * @brief setCallback remember callback,
+     * pass null delegate to remove it.
+     * @param callback
+     */
+    void setCallback(InputDelegate callback);
+    /**
+     * @brief updateData concatenates name and surname
+     * with space between, stores result to m_data and
+     * calls callback if it's not null.
+     * @param name
+     * @param surname
+     */
+    void updateData(QString name, QString surname);
+
+private:
+    QString m_data;
+    InputDelegate m_callback;
+
+    friend class SignalSlotKoan;
+};
+
+#endif // DELEGATE_CALLBACKS_H
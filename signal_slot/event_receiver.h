@@ -0,0 +1,167 @@
+#ifndef EVENT_RECEIVER_H
+#define EVENT_RECEIVER_H
+
+#include <QString>
+
+#include <type_traits>
+
+#include "delegate.h"
+
+/**
+ * Third question from callbacks.h asks how many base classes
+ * you need to receive 10 kinds of notifications. With Callback-like
+ * interfaces the answer is 10, and every object carries 10 vtable
+ * pointers. Here receiver lists all events it handles as template
+ * parameters and implements onEvent() overload for each of them.
+ * Provider of every event kind keeps Delegate (see delegate.h)
+ * bound directly to that overload, so there are no virtual functions
+ * and no vtable pointers in receiver at all.
+ * Like first callbacks koan this doesn't track lifetime of receiver,
+ * receiver must disconnect from providers before it's deleted.
+ */
+
+/**
+ * @brief The TypeListContains struct
+ * value is true if T is one of List.
+ */
+template <class T, class... List>
+struct TypeListContains;
+
+template <class T>
+struct TypeListContains<T> : std::false_type
+{};
+
+template <class T, class Head, class... Tail>
+struct TypeListContains<T, Head, Tail...>
+        : std::conditional<std::is_same<T, Head>::value,
+                           std::true_type,
+                           TypeListContains<T, Tail...> >::type
+{};
+
+/**
+ * @brief The EventProvider class
+ * sends events of one kind to its receiver.
+ */
+template <class Event>
+class EventProvider
+{
+public:
+    typedef Delegate<void(const Event &)> Slot;
+
+    EventProvider()
+        : m_receiver(NULL)
+    {}
+
+    /**
+     * @brief setReceiver binds receiver's
+     * onEvent(const Event &) overload.
+     * @param receiver
+     */
+    template <class R>
+    void setReceiver(R* receiver)
+    {
+        m_slot = Slot::template fromMethod<R, &R::onEvent>(receiver);
+        m_receiver = receiver;
+    }
+
+    /**
+     * @brief removeReceiver unbinds receiver,
+     * does nothing if provider is bound to another receiver.
+     * @param receiver
+     * @return true if receiver was removed
+     */
+    bool removeReceiver(const void* receiver)
+    {
+        if (m_slot.isNull() || m_receiver != receiver)
+            return false;
+        m_slot = Slot();
+        m_receiver = NULL;
+        return true;
+    }
+
+    bool hasReceiver() const
+    {
+        return !m_slot.isNull();
+    }
+
+    /**
+     * @brief sendEvent calls receiver if it's set.
+     * @param event
+     */
+    void sendEvent(const Event &event) const
+    {
+        if (m_slot)
+            m_slot(event);
+    }
+
+private:
+    Slot m_slot;
+    // receiver bound to m_slot
+    const void* m_receiver;
+};
+
+/**
+ * @brief The Receiver class
+ * base for classes that receive Events.
+ * Derived class must implement
+ * void onEvent(const Event &) for each of Events.
+ * Usage:
+ * class MyReceiver : public Receiver<MyReceiver, InputEvent, MouseClickEvent>
+ * {
+ * public:
+ *     void onEvent(const InputEvent &event);
+ *     void onEvent(const MouseClickEvent &event);
+ * };
+ */
+template <class Derived, class... Events>
+class Receiver
+{
+public:
+    /**
+     * @brief connectTo registers receiver in provider,
+     * compilation fails if Event isn't one of Events.
+     * @param provider
+     */
+    template <class Event>
+    void connectTo(EventProvider<Event> &provider)
+    {
+        static_assert(TypeListContains<Event, Events...>::value,
+                      "receiver doesn't handle this kind of event");
+        provider.setReceiver(static_cast<Derived*>(this));
+    }
+
+    /**
+     * @brief disconnectFrom removes receiver from provider,
+     * provider connected to another receiver is left as is.
+     * @param provider
+     * @return true if receiver was connected to provider
+     */
+    template <class Event>
+    bool disconnectFrom(EventProvider<Event> &provider)
+    {
+        return provider.removeReceiver(static_cast<Derived*>(this));
+    }
+};
+
+/**
+ * @brief The InputEvent struct
+ * user entered some data.
+ */
+struct InputEvent
+{
+    QString data;
+};
+
+/**
+ * @brief The MouseClickEvent struct
+ * same as MouseClickMessage from message_bus.h,
+ * but without base class.
+ */
+struct MouseClickEvent
+{
+    int x;
+    int y;
+    int button;
+};
+
+#endif // EVENT_RECEIVER_H
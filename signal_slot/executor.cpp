@@ -0,0 +1,146 @@
+#include "executor.h"
+
+#include <QMetaObject>
+#include <QRunnable>
+
+#include <thread>
+#include <utility>
+
+Executor::~Executor()
+{}
+
+void InlineExecutor::post(Task task)
+{
+    task();
+}
+
+namespace
+{
+
+class TaskRunnable : public QRunnable
+{
+public:
+    explicit TaskRunnable(Task task)
+        : m_task(std::move(task))
+    {}
+
+    void run()
+    {
+        m_task();
+    }
+
+private:
+    Task m_task;
+};
+
+}
+
+ThreadPoolExecutor::ThreadPoolExecutor(QThreadPool* pool)
+    : m_pool(pool)
+{}
+
+void ThreadPoolExecutor::post(Task task)
+{
+    m_pool->start(new TaskRunnable(std::move(task)));
+}
+
+MailboxExecutor::MailboxExecutor(QObject* context)
+    : m_head(&m_stub)
+    , m_tail(&m_stub)
+    , m_pending(0)
+    , m_context(context)
+    , m_self(std::make_shared<MailboxExecutor*>(this))
+{
+    m_stub.next.store(nullptr);
+}
+
+MailboxExecutor::~MailboxExecutor()
+{
+    while (Node* node = pop())
+        delete node;
+}
+
+void MailboxExecutor::post(Task task)
+{
+    Node* node = new Node;
+    node->task = std::move(task);
+    push(node);
+    // only the task that made mailbox non empty wakes owner
+    if (m_pending.fetch_add(1) == 0)
+        wake();
+}
+
+int MailboxExecutor::runPending()
+{
+    int total = 0;
+    for (;;)
+    {
+        int processed = 0;
+        while (Node* node = pop())
+        {
+            node->task();
+            delete node;
+            ++processed;
+        }
+        total += processed;
+        int remaining = m_pending.fetch_sub(processed) - processed;
+        if (remaining == 0)
+            break;
+        // some producer has counted its task, but didn't link it yet
+        if (m_context)
+        {
+            wake();
+            break;
+        }
+        std::this_thread::yield();
+    }
+    return total;
+}
+
+void MailboxExecutor::wake()
+{
+    if (!m_context)
+        return;
+    std::weak_ptr<MailboxExecutor*> self = m_self;
+    QMetaObject::invokeMethod(m_context, [self] () -> void
+    {
+        if (std::shared_ptr<MailboxExecutor*> mailbox = self.lock())
+            (*mailbox)->runPending();
+    }, Qt::QueuedConnection);
+}
+
+void MailboxExecutor::push(Node* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+MailboxExecutor::Node* MailboxExecutor::pop()
+{
+    Node* tail = m_tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &m_stub)
+    {
+        if (next == nullptr)
+            return nullptr;
+        m_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr)
+    {
+        m_tail = next;
+        return tail;
+    }
+    if (tail != m_head.load(std::memory_order_acquire))
+        return nullptr;
+    push(&m_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
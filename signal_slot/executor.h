@@ -0,0 +1,117 @@
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <QObject>
+#include <QPointer>
+#include <QThreadPool>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/**
+ * Executor decides where and when a piece of work runs.
+ * Provider that knows receiver's executor doesn't call receiver
+ * directly, but posts invocation to its executor, so receiver
+ * always runs in its own thread and doesn't need to lock its data.
+ * It's the same idea as Qt::QueuedConnection, where event loop
+ * of receiver's thread is the executor.
+ */
+
+typedef std::function<void()> Task;
+
+/**
+ * @brief The Executor class
+ * base class for executors.
+ */
+class Executor
+{
+public:
+    virtual ~Executor();
+    /**
+     * @brief post schedules task for execution,
+     * can be called from any thread.
+     * @param task
+     */
+    virtual void post(Task task) = 0;
+};
+
+/**
+ * @brief The InlineExecutor class
+ * runs task immediately in calling thread,
+ * same as direct callback.
+ */
+class InlineExecutor : public Executor
+{
+public:
+    void post(Task task);
+};
+
+/**
+ * @brief The ThreadPoolExecutor class
+ * runs tasks in QThreadPool, tasks may run
+ * simultaneously in different threads.
+ */
+class ThreadPoolExecutor : public Executor
+{
+public:
+    explicit ThreadPoolExecutor(QThreadPool* pool = QThreadPool::globalInstance());
+
+    void post(Task task);
+
+private:
+    QThreadPool* m_pool;
+};
+
+/**
+ * @brief The MailboxExecutor class
+ * is a mailbox of one thread. Any thread can post tasks
+ * (without locks), and owner thread runs them in order of posting.
+ * Owner can call runPending() itself, or pass QObject living in owner
+ * thread as context, then runPending() is scheduled in its event loop
+ * each time mailbox becomes non empty. In that case mailbox must be
+ * deleted in owner thread.
+ */
+class MailboxExecutor : public Executor
+{
+public:
+    explicit MailboxExecutor(QObject* context = NULL);
+    /**
+     * Tasks that were not run are destroyed.
+     */
+    ~MailboxExecutor();
+
+    void post(Task task);
+    /**
+     * @brief runPending runs tasks posted so far,
+     * must be called only from owner thread.
+     * @return number of tasks that were run.
+     */
+    int runPending();
+
+private:
+    Q_DISABLE_COPY(MailboxExecutor)
+
+    struct Node
+    {
+        std::atomic<Node*> next;
+        Task task;
+    };
+
+    void push(Node* node);
+    Node* pop();
+    void wake();
+
+    // intrusive multiple producers single consumer queue:
+    // producers push to m_head, consumer pops from m_tail
+    std::atomic<Node*> m_head;
+    Node* m_tail;
+    Node m_stub;
+    std::atomic<int> m_pending;
+    QPointer<QObject> m_context;
+    // scheduled runPending() calls hold weak reference to it,
+    // so they do nothing after mailbox is deleted
+    std::shared_ptr<MailboxExecutor*> m_self;
+};
+
+#endif // EXECUTOR_H
@@ -0,0 +1,102 @@
+#include "executor_callbacks.h"
+
+#include <QStringBuilder>
+
+typedef std::lock_guard<std::mutex> guard;
+
+ExecutorInputDataProvider::Subscription::Subscription(Callback* callback,
+                                                      Executor* executor)
+    : callback(callback)
+    , executor(executor)
+    , active(true)
+    , scheduled(false)
+{}
+
+void ExecutorInputDataProvider::Subscription::deliver()
+{
+    // scheduled stays set until nothing is pending, so updates
+    // arriving while burst is delivered are picked up by this loop
+    // and never by second task, that could run concurrently
+    // on another thread of pool
+    for (;;)
+    {
+        QStringList burst;
+        {
+            guard g(mutex);
+            if (pending.isEmpty())
+            {
+                scheduled = false;
+                return;
+            }
+            burst.swap(pending);
+        }
+        for (const QString &data : burst)
+        {
+            if (!active.load())
+                return;
+            callback->inputReady(data);
+        }
+    }
+}
+
+ExecutorInputDataProvider::ExecutorInputDataProvider()
+{}
+
+ExecutorInputDataProvider::~ExecutorInputDataProvider()
+{
+    guard g(m_mutex);
+    for (const SubscriptionPtr &subscription : m_subscriptions)
+        subscription->active.store(false);
+}
+
+void ExecutorInputDataProvider::addReceiver(Callback* callback,
+                                            Executor* executor)
+{
+    guard g(m_mutex);
+    m_subscriptions.append(SubscriptionPtr(new Subscription(callback, executor)));
+}
+
+void ExecutorInputDataProvider::removeReceiver(Callback* callback)
+{
+    guard g(m_mutex);
+    for (int i = 0; i < m_subscriptions.size(); ++i)
+    {
+        if (m_subscriptions[i]->callback == callback)
+        {
+            m_subscriptions[i]->active.store(false);
+            m_subscriptions.remove(i);
+            return;
+        }
+    }
+}
+
+void ExecutorInputDataProvider::updateData(QString name, QString surname)
+{
+    m_data = name % QLatin1Char(' ') % surname;
+
+    // implicitly shared copy, so executors (ex. InlineExecutor)
+    // run tasks without m_mutex locked
+    QVector<SubscriptionPtr> subscriptions;
+    {
+        guard g(m_mutex);
+        subscriptions = m_subscriptions;
+    }
+    for (const SubscriptionPtr &subscription : subscriptions)
+    {
+        bool post;
+        {
+            guard pendingGuard(subscription->mutex);
+            subscription->pending.append(m_data);
+            post = !subscription->scheduled;
+            subscription->scheduled = true;
+        }
+        if (post)
+        {
+            SubscriptionPtr task = subscription;
+            subscription->executor->post([task] () -> void
+            {
+                task->deliver();
+            });
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef EXECUTOR_CALLBACKS_H
+#define EXECUTOR_CALLBACKS_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <memory>
+#include <mutex>
+
+#include "callbacks.h"
+#include "executor.h"
+
+class SignalSlotKoan;
+
+/**
+ * @brief The ExecutorInputDataProvider class
+ * sends input data to receivers through their executors,
+ * so receiver's inputReady() is always called where receiver
+ * wants it to be called (ex. in its own thread).
+ * If provider sends data faster than receiver's executor runs
+ * posted tasks, updates are accumulated and whole burst
+ * is delivered by single task.
+ */
+class ExecutorInputDataProvider
+{
+public:
+    ExecutorInputDataProvider();
+    ~ExecutorInputDataProvider();
+
+    /**
+     * @brief addReceiver registers callback, which will be
+     * called through executor. Executor must outlive registration.
+     * @param callback
+     * @param executor
+     */
+    void addReceiver(Callback* callback, Executor* executor);
+    /**
+     * @brief removeReceiver unregisters callback. Updates that
+     * were posted, but not delivered yet are dropped.
+     * Call it in thread where receiver's executor runs tasks,
+     * then callback is never called after removeReceiver() returns.
+     * @param callback
+     */
+    void removeReceiver(Callback* callback);
+    /**
+     * @brief updateData concatenates name and surname with
+     * space between, stores result to m_data and posts it
+     * to every receiver.
+     * @param name
+     * @param surname
+     */
+    void updateData(QString name, QString surname);
+
+private:
+    Q_DISABLE_COPY(ExecutorInputDataProvider)
+
+    /**
+     * Subscription is shared between provider and
+     * tasks posted to executor, so it lives until both
+     * are done with it.
+     */
+    struct Subscription
+    {
+        Subscription(Callback* callback, Executor* executor);
+
+        void deliver();
+
+        Callback* const callback;
+        Executor* const executor;
+        std::atomic<bool> active;
+        std::mutex mutex;
+        QStringList pending;
+        bool scheduled;
+    };
+    typedef std::shared_ptr<Subscription> SubscriptionPtr;
+
+    QString m_data;
+    QVector<SubscriptionPtr> m_subscriptions;
+    std::mutex m_mutex;
+
+    friend class SignalSlotKoan;
+};
+
+#endif // EXECUTOR_CALLBACKS_H
@@ -0,0 +1,275 @@
+#ifndef FAST_SIGNAL_H
+#define FAST_SIGNAL_H
+
+#include <QObject>
+#include <QVector>
+
+#include <memory>
+#include <utility>
+
+#include "delegate.h"
+#ifdef QTKOANS_TRACE
+#include "tracer.h"
+#endif
+
+/**
+ * Qt's signal goes through moc generated code: arguments are packed
+ * into array of void pointers, connection list is looked up and
+ * every slot is called through metacall. It's a price for queued
+ * connections, thread safety and introspection.
+ * If you need to notify thousands of slots in one thread as fast as
+ * possible, Signal below is just an array of Delegates (see delegate.h)
+ * which are called one by one. It doesn't need moc and lives only in
+ * this header. It isn't thread safe: connect, disconnect and emission
+ * must happen in one thread.
+ */
+
+template <class... Args>
+class Signal
+{
+public:
+    typedef Delegate<void(Args...)> Slot;
+
+private:
+    struct Entry
+    {
+        Slot slot;
+        quint64 id;
+        // destroyed() of context object, if slot has one
+        QMetaObject::Connection context;
+    };
+
+    struct State
+    {
+        State()
+            : nextId(1)
+            , emitting(0)
+            , dirty(false)
+        {}
+
+        ~State()
+        {
+            // context objects can outlive signal
+            for (const Entry &entry : entries)
+                QObject::disconnect(entry.context);
+        }
+
+        void disconnect(quint64 id)
+        {
+            for (int i = 0; i < entries.size(); ++i)
+            {
+                if (entries[i].id != id)
+                    continue;
+                QObject::disconnect(entries[i].context);
+                if (emitting > 0)
+                {
+                    // array is being iterated, remove it later
+                    entries[i].slot = Slot();
+                    dirty = true;
+                }
+                else
+                {
+                    entries.remove(i);
+                }
+                return;
+            }
+        }
+
+        void compact()
+        {
+            int out = 0;
+            for (int i = 0; i < entries.size(); ++i)
+            {
+                if (!entries[i].slot.isNull())
+                    entries[out++] = entries[i];
+            }
+            entries.resize(out);
+            dirty = false;
+        }
+
+        QVector<Entry> entries;
+        quint64 nextId;
+        int emitting;
+        bool dirty;
+    };
+
+public:
+    /**
+     * @brief The Connection class
+     * disconnects slot when destroyed (unless released).
+     * It's safe to destroy connection after signal.
+     */
+    class Connection
+    {
+    public:
+        Connection()
+            : m_id(0)
+        {}
+
+        Connection(Connection &&other)
+            : m_state(std::move(other.m_state))
+            , m_id(other.m_id)
+        {
+            other.m_id = 0;
+        }
+
+        Connection &operator=(Connection &&other)
+        {
+            if (this != &other)
+            {
+                disconnect();
+                m_state = std::move(other.m_state);
+                m_id = other.m_id;
+                other.m_id = 0;
+            }
+            return *this;
+        }
+
+        ~Connection()
+        {
+            disconnect();
+        }
+
+        bool isConnected() const
+        {
+            return m_id != 0 && !m_state.expired();
+        }
+
+        void disconnect()
+        {
+            if (std::shared_ptr<State> state = m_state.lock())
+                state->disconnect(m_id);
+            m_state.reset();
+            m_id = 0;
+        }
+
+        /**
+         * @brief release slot stays connected
+         * for the lifetime of signal.
+         */
+        void release()
+        {
+            m_state.reset();
+            m_id = 0;
+        }
+
+    private:
+        Connection(const std::shared_ptr<State> &state, quint64 id)
+            : m_state(state)
+            , m_id(id)
+        {}
+
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+
+        std::weak_ptr<State> m_state;
+        quint64 m_id;
+
+        friend class Signal;
+    };
+
+    Signal()
+        : m_state(std::make_shared<State>())
+    {}
+
+    /**
+     * @brief connect
+     * @param slot
+     * @return connection, slot is disconnected
+     * when connection is destroyed.
+     */
+    Connection connect(Slot slot)
+    {
+        Entry entry;
+        entry.slot = slot;
+        entry.id = m_state->nextId++;
+        m_state->entries.append(entry);
+        return Connection(m_state, entry.id);
+    }
+
+    template <class T, void (T::*Method)(Args...)>
+    Connection connect(T* object)
+    {
+        return connect(Slot::template fromMethod<T, Method>(object));
+    }
+
+    /**
+     * @brief connect connects slot with context,
+     * like context object in QObject::connect().
+     * Slot is disconnected when context is destroyed,
+     * or earlier by connection. Call release() on connection
+     * to keep slot for lifetime of context (and signal).
+     * @param slot
+     * @param context
+     * @return connection, slot is disconnected
+     * when connection is destroyed.
+     */
+    Connection connect(Slot slot, QObject* context)
+    {
+        Connection connection = connect(slot);
+        std::weak_ptr<State> state = m_state;
+        quint64 id = connection.m_id;
+        m_state->entries.last().context = QObject::connect(
+                    context, &QObject::destroyed, [state, id] () -> void
+        {
+            if (std::shared_ptr<State> alive = state.lock())
+                alive->disconnect(id);
+        });
+        return connection;
+    }
+
+    /**
+     * @brief connectObject connects QObject's method for its lifetime.
+     * @param object
+     */
+    template <class T, void (T::*Method)(Args...)>
+    void connectObject(T* object)
+    {
+        connect(Slot::template fromMethod<T, Method>(object), object).release();
+    }
+
+    int slotCount() const
+    {
+        int count = 0;
+        for (const Entry &entry : m_state->entries)
+        {
+            if (!entry.slot.isNull())
+                ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief operator () calls every connected slot in order
+     * of connection. Slots connected during emission are not
+     * called, slots disconnected during emission are not called
+     * if they were not called yet.
+     */
+    void operator()(Args... args) const
+    {
+#ifdef QTKOANS_TRACE
+        static const InternedString emitName(QStringLiteral("Signal::emit"));
+        TraceScope scope(emitName);
+#endif
+        State &state = *m_state;
+        const int size = state.entries.size();
+        ++state.emitting;
+        for (int i = 0; i < size; ++i)
+        {
+            // copy, as array can be reallocated by slot
+            Slot slot = state.entries.at(i).slot;
+            if (slot)
+                slot(args...);
+        }
+        if (--state.emitting == 0 && state.dirty)
+            state.compact();
+    }
+
+private:
+    Signal(const Signal &) = delete;
+    Signal &operator=(const Signal &) = delete;
+
+    std::shared_ptr<State> m_state;
+};
+
+#endif // FAST_SIGNAL_H
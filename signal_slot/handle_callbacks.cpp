@@ -0,0 +1,79 @@
+#include "handle_callbacks.h"
+
+#include <QStringBuilder>
+
+#include <utility>
+
+SlotMap<Callback> &callbackSlots()
+{
+    static SlotMap<Callback> map;
+    return map;
+}
+
+SlotMap<HandleInputDataProvider> &providerSlots()
+{
+    static SlotMap<HandleInputDataProvider> map;
+    return map;
+}
+
+HandleInputDataProvider::HandleInputDataProvider()
+    : m_self(providerSlots().insert(this))
+{}
+
+HandleInputDataProvider::~HandleInputDataProvider()
+{
+    providerSlots().remove(m_self);
+}
+
+ProviderHandle HandleInputDataProvider::handle() const
+{
+    return m_self;
+}
+
+void HandleInputDataProvider::setCallback(CallbackHandle callback)
+{
+    m_callback = callback;
+}
+
+void HandleInputDataProvider::updateData(QString name, QString surname)
+{
+    m_data = name % QLatin1Char(' ') % surname;
+    Callback* callback = callbackSlots().get(m_callback);
+    if (callback != NULL)
+        callback->inputReady(m_data);
+}
+
+HandleInputDataReceiver::HandleInputDataReceiver()
+    : m_self(callbackSlots().insert(this))
+{}
+
+HandleInputDataReceiver::~HandleInputDataReceiver()
+{
+    callbackSlots().remove(m_self);
+}
+
+CallbackHandle HandleInputDataReceiver::handle() const
+{
+    return m_self;
+}
+
+void HandleInputDataReceiver::inputReady(QString data)
+{
+    m_data = std::move(data);
+}
+
+void HandleInputDataReceiver::setProvider(HandleInputDataProvider* provider)
+{
+    if (provider == NULL)
+    {
+        m_provider = ProviderHandle();
+        return;
+    }
+    m_provider = provider->handle();
+    provider->setCallback(m_self);
+}
+
+HandleInputDataProvider* HandleInputDataReceiver::provider() const
+{
+    return providerSlots().get(m_provider);
+}
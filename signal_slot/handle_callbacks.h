@@ -0,0 +1,118 @@
+#ifndef HANDLE_CALLBACKS_H
+#define HANDLE_CALLBACKS_H
+
+#include <QString>
+
+#include "callbacks.h"
+#include "slot_map.h"
+
+class SignalSlotKoan;
+class HandleInputDataProvider;
+class HandleInputDataReceiver;
+
+/**
+ * Remember cross references for deletion notification from
+ * callbacks.h? InputDataReceiver2 and provider need to notify
+ * each other then deleted, and it gets complicated pretty fast.
+ * Here we take another approach: every provider and receiver
+ * registers itself in a slot map (see slot_map.h) and keeps
+ * only handles of others. Any of them can be deleted at any time,
+ * the other side will just find out that handle is stale
+ * next time it tries to use it.
+ * Note that slot maps are global and not synchronized, so
+ * all providers and receivers must live in one thread.
+ */
+
+typedef SlotHandle<Callback> CallbackHandle;
+typedef SlotHandle<HandleInputDataProvider> ProviderHandle;
+
+/**
+ * @brief callbackSlots
+ * @return slot map of alive receivers.
+ */
+SlotMap<Callback> &callbackSlots();
+/**
+ * @brief providerSlots
+ * @return slot map of alive providers.
+ */
+SlotMap<HandleInputDataProvider> &providerSlots();
+
+/**
+ * @brief The HandleInputDataProvider class
+ * sends input data to callback referenced by handle.
+ */
+class HandleInputDataProvider
+{
+public:
+    HandleInputDataProvider();
+    ~HandleInputDataProvider();
+
+    /**
+     * @brief handle
+     * @return handle of this provider.
+     */
+    ProviderHandle handle() const;
+    /**
+     * @brief setCallback remember callback handle.
+     * @param callback
+     */
+    void setCallback(CallbackHandle callback);
+    /**
+     * @brief updateData concatenates name and surname
+     * with space between, stores result to m_data and
+     * calls callback if it's still alive.
+     * @param name
+     * @param surname
+     */
+    void updateData(QString name, QString surname);
+
+private:
+    Q_DISABLE_COPY(HandleInputDataProvider)
+
+    QString m_data;
+    ProviderHandle m_self;
+    CallbackHandle m_callback;
+
+    friend class SignalSlotKoan;
+};
+
+/**
+ * @brief The HandleInputDataReceiver class
+ * receives input data from provider and holds only
+ * handle to it.
+ */
+class HandleInputDataReceiver : public Callback
+{
+public:
+    HandleInputDataReceiver();
+    ~HandleInputDataReceiver();
+
+    /**
+     * @brief handle
+     * @return handle of this receiver.
+     */
+    CallbackHandle handle() const;
+    void inputReady(QString data);
+    /**
+     * @brief setProvider registers this receiver as callback
+     * in provider and remembers provider's handle.
+     * @param provider
+     */
+    void setProvider(HandleInputDataProvider* provider);
+    /**
+     * @brief provider
+     * @return provider, or NULL if it was deleted or never set.
+     */
+    HandleInputDataProvider* provider() const;
+
+private:
+    Q_DISABLE_COPY(HandleInputDataReceiver)
+
+    QString m_data;
+    CallbackHandle m_self;
+    ProviderHandle m_provider;
+
+    friend class SignalSlotKoan;
+};
+
+#endif // HANDLE_CALLBACKS_H
@@ -0,0 +1,62 @@
+#include "interned_string.h"
+
+#include <QHash>
+
+#include <mutex>
+
+typedef std::lock_guard<std::mutex> guard;
+
+static const QString* nullString()
+{
+    static const QString null;
+    return &null;
+}
+
+static const QString* intern(const QString &string)
+{
+    // Strings are never removed from the table,
+    // so pointers handed out stay valid forever.
+    static QHash<QString, const QString*> table;
+    static std::mutex mutex;
+
+    guard g(mutex);
+    auto i = table.constFind(string);
+    if (i != table.constEnd())
+        return i.value();
+    const QString* interned = new QString(string);
+    table.insert(*interned, interned);
+    return interned;
+}
+
+InternedString::InternedString()
+    : m_string(nullString())
+{}
+
+InternedString::InternedString(const QString &string)
+    : m_string(intern(string))
+{}
+
+bool InternedString::isNull() const
+{
+    return m_string == nullString();
+}
+
+const QString &InternedString::toString() const
+{
+    return *m_string;
+}
+
+bool InternedString::operator==(const InternedString &other) const
+{
+    return m_string == other.m_string;
+}
+
+bool InternedString::operator!=(const InternedString &other) const
+{
+    return m_string != other.m_string;
+}
+
+uint qHash(const InternedString &string, uint seed)
+{
+    return qHash(&string.toString(), seed);
+}
@@ -0,0 +1,57 @@
+#ifndef INTERNED_STRING_H
+#define INTERNED_STRING_H
+
+#include <QString>
+
+/**
+ * When the same short strings (like "hello") travel through
+ * message bus again and again, every message allocates its own
+ * QString and every receiver copies it once more.
+ * Interning solves this: each distinct string is stored only once
+ * in a global table and messages carry a pointer to the stored copy.
+ * Two interned strings are equal when their pointers are equal,
+ * so comparison costs one pointer compare instead of comparing
+ * characters.
+ * Note that interned strings live until the end of the programm,
+ * so intern only repetitive strings and not arbitrary user input.
+ */
+
+/**
+ * @brief The InternedString class
+ * is a handle (atom) to a string stored in global
+ * intern table. It is as cheap to copy as a pointer.
+ */
+class InternedString
+{
+public:
+    /**
+     * @brief InternedString creates null atom,
+     * toString() of null atom returns empty string.
+     */
+    InternedString();
+    /**
+     * @brief InternedString looks up string in intern table
+     * (adding it there if it's not present yet).
+     * Thread safe.
+     * @param string
+     */
+    explicit InternedString(const QString &string);
+
+    bool isNull() const;
+    /**
+     * @brief toString view of interned string,
+     * reference stays valid until the end of the programm.
+     * @return
+     */
+    const QString &toString() const;
+
+    bool operator==(const InternedString &other) const;
+    bool operator!=(const InternedString &other) const;
+
+private:
+    const QString* m_string;
+};
+
+uint qHash(const InternedString &string, uint seed = 0);
+
+#endif // INTERNED_STRING_H
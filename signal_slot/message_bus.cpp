@@ -1,10 +1,12 @@
 #include "message_bus.h"
 
+#include <algorithm>
 #include <vector>
 #include <mutex>
 
-static void registerMessageReceiver(MessageReceiver* receiver);
-static void removeMessageReceiver(MessageReceiver* receiver);
+#ifdef QTKOANS_TRACE
+#include "tracer.h"
+#endif
 
 MessageReceiver::MessageReceiver()
 {
@@ -38,6 +40,9 @@ void sendHelloMessage()
      * parameters "0" and "hello".
      * Then send it to the bus using
      * sendMessage(MessageBase*).
+     * As "hello" is sent over and over, you can
+     * keep it as static InternedString and pass it
+     * to message instead of QString.
      */
 }
 
@@ -73,6 +78,11 @@ MessageBase::MessageBase(int type, QString message)
     , m_message(message)
 {}
 
+MessageBase::MessageBase(int type, InternedString message)
+    : m_type(type)
+    , m_atom(message)
+{}
+
 MessageBase::~MessageBase()
 {}
 
@@ -83,7 +93,17 @@ int MessageBase::type() const
 
 QString MessageBase::message() const
 {
-    return m_message;
+    return messageView();
+}
+
+const QString &MessageBase::messageView() const
+{
+    return m_atom.isNull() ? m_message : m_atom.toString();
+}
+
+InternedString MessageBase::atom() const
+{
+    return m_atom;
 }
 
 MouseClickMessage::MouseClickMessage()
@@ -127,7 +147,8 @@ typedef std::lock_guard<std::mutex> guard;
 void registerMessageReceiver(MessageReceiver* receiver)
 {
     guard g(__bus_mutex);
-    __receivers.push_back(receiver);
+    if (std::find(__receivers.begin(), __receivers.end(), receiver) == __receivers.end())
+        __receivers.push_back(receiver);
 }
 
 void removeMessageReceiver(MessageReceiver* receiver)
@@ -146,6 +167,9 @@ void sendMessage(MessageBase* message)
 
 void deliverMessages()
 {
+#ifdef QTKOANS_TRACE
+    static const InternedString deliverName(QStringLiteral("MessageBus::deliver"));
+#endif
     guard g(__bus_mutex);
     std::for_each(__messages.begin(), __messages.end(),
                   [] (MessageBase* message) -> void
@@ -153,6 +177,9 @@ void deliverMessages()
         std::for_each(__receivers.begin(), __receivers.end(),
                       [message] (MessageReceiver* receiver) -> void
         {
+#ifdef QTKOANS_TRACE
+            TraceScope scope(deliverName);
+#endif
             receiver->messageReceived(message);
         });
         delete message;
@@ -3,6 +3,8 @@
 
 #include <QString>
 
+#include "interned_string.h"
+
 class SignalSlotKoan;
 
 /**
@@ -31,6 +33,13 @@ class MessageBase
 public:
     MessageBase();
     MessageBase(int type, QString message = QString());
+    /**
+     * @brief MessageBase creates message carrying interned string,
+     * no string data is allocated or copied for such message.
+     * @param type
+     * @param message
+     */
+    MessageBase(int type, InternedString message);
     virtual ~MessageBase();
 
     /**
@@ -43,10 +52,26 @@ public:
      * @return
      */
     QString message() const;
+    /**
+     * @brief messageView same as message(), but returns
+     * reference to string stored in message (or in intern table),
+     * so receiver doesn't pay for a copy if it only wants to
+     * look at the string. Valid while message is alive.
+     * @return
+     */
+    const QString &messageView() const;
+    /**
+     * @brief atom interned message string, null atom if message
+     * was created from plain QString.
+     * Atoms can be compared with a single pointer compare.
+     * @return
+     */
+    InternedString atom() const;
 
 private:
     int m_type;
     QString m_message;
+    InternedString m_atom;
 };
 
 /**
@@ -93,6 +118,22 @@ public:
     virtual void messageReceived(MessageBase* message) = 0;
 };
 
+/**
+ * @brief registerMessageReceiver adds receiver to the bus,
+ * receiver that is already registered is ignored.
+ * MessageReceiver calls it for you, it's public for
+ * code that has to register receiver itself (ex. benchmark
+ * that must work before MessageReceiver koan is solved).
+ * @param receiver
+ */
+void registerMessageReceiver(MessageReceiver* receiver);
+/**
+ * @brief removeMessageReceiver removes receiver from the bus,
+ * does nothing if receiver isn't registered.
+ * @param receiver
+ */
+void removeMessageReceiver(MessageReceiver* receiver);
+
 /**
  * @brief The SimpleMessageReceiver class
  * now we create a simple message receiver
@@ -110,6 +151,8 @@ public:
     /**
      * @brief messageReceived go to .cpp file
      * and store string from message.
+     * Prefer message->messageView() to message->message(),
+     * as it doesn't create temporary QString.
      * @param message
      */
     void messageReceived(MessageBase* message);
@@ -0,0 +1,57 @@
+#include "multi_callbacks.h"
+
+#include <QStringBuilder>
+
+#include <utility>
+
+MultiInputDataProvider::MultiInputDataProvider()
+{}
+
+void MultiInputDataProvider::setCallback(Callback* callback)
+{
+    if (callback == NULL)
+        return;
+    for (int i = 0; i < m_callbacks.size(); ++i)
+    {
+        if (m_callbacks[i] == callback)
+            return;
+    }
+    m_callbacks.append(callback);
+}
+
+void MultiInputDataProvider::removeCallback(Callback* callback)
+{
+    for (int i = 0; i < m_callbacks.size(); ++i)
+    {
+        if (m_callbacks[i] == callback)
+        {
+            m_callbacks.remove(i);
+            return;
+        }
+    }
+}
+
+int MultiInputDataProvider::callbackCount() const
+{
+    return m_callbacks.size();
+}
+
+void MultiInputDataProvider::updateData(QString name, QString surname)
+{
+    m_data = name % QLatin1Char(' ') % surname;
+    notify();
+}
+
+void MultiInputDataProvider::updateData(QString record)
+{
+    m_data = std::move(record);
+    notify();
+}
+
+void MultiInputDataProvider::notify()
+{
+    Callback* const* callback = m_callbacks.constData();
+    Callback* const* end = callback + m_callbacks.size();
+    for (; callback != end; ++callback)
+        (*callback)->inputReady(m_data);
+}
@@ -0,0 +1,87 @@
+#ifndef MULTI_CALLBACKS_H
+#define MULTI_CALLBACKS_H
+
+#include <QString>
+#include <QVarLengthArray>
+
+#include "callbacks.h"
+
+class SignalSlotKoan;
+
+/**
+ * This is one of possible answers to the first question from
+ * callbacks.h: provider that can notify multiple receivers.
+ * Instead of single m_callback pointer it keeps array of them.
+ * Most providers have only a few receivers, so we use
+ * QVarLengthArray, which keeps first elements inside the object
+ * itself, and registering up to 4 receivers doesn't touch heap at all.
+ * (Read http://doc.qt.io/qt-5/qvarlengtharray.html).
+ */
+
+/**
+ * @brief The MultiInputDataProvider class
+ * sends input data to every registered callback.
+ * It's not thread safe, all calls must be done from
+ * one thread.
+ */
+class MultiInputDataProvider : public ProviderInterface
+{
+public:
+    /**
+     * @brief InlineCallbacks number of callbacks
+     * stored without heap allocation.
+     */
+    enum { InlineCallbacks = 4 };
+
+    MultiInputDataProvider();
+
+    /**
+     * @brief setCallback adds callback to the list of
+     * receivers, callback that is already registered is ignored.
+     * @param callback
+     */
+    void setCallback(Callback* callback);
+    /**
+     * @brief removeCallback removes callback from the list
+     * of receivers.
+     * Callbacks must not be added or removed from inside
+     * of Callback::inputReady() called by this provider.
+     * @param callback
+     */
+    void removeCallback(Callback* callback);
+    /**
+     * @brief callbackCount
+     * @return number of registered callbacks.
+     */
+    int callbackCount() const;
+    /**
+     * @brief updateData concatenates name and surname
+     * with space between, stores result to m_data and
+     * notifies every registered callback in order of registration.
+     * Result is built with QStringBuilder, so exactly one
+     * allocation of exact size is made per call, and receivers
+     * get implicitly shared copy of m_data.
+     * @param name
+     * @param surname
+     */
+    void updateData(QString name, QString surname);
+    /**
+     * @brief updateData same as above, but takes
+     * ready record, which is moved to m_data.
+     * Pass temporary or QStringBuilder expression
+     * (ex. name % QLatin1Char(' ') % surname)
+     * so no extra copy is made.
+     * @param record
+     */
+    void updateData(QString record);
+
+private:
+    void notify();
+
+    QString m_data;
+    QVarLengthArray<Callback*, InlineCallbacks> m_callbacks;
+
+    friend class SignalSlotKoan;
+};
+
+#endif // MULTI_CALLBACKS_H
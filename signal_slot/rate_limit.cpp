@@ -0,0 +1,182 @@
+#include "rate_limit.h"
+
+#include <QVarLengthArray>
+
+#include <limits>
+#include <utility>
+
+TimerClient::~TimerClient()
+{}
+
+TimerService::TimerService()
+{
+    m_clock.start();
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&m_timer, &QTimer::timeout, [this] () -> void
+    {
+        onTimeout();
+    });
+}
+
+qint64 TimerService::now() const
+{
+    return m_clock.elapsed();
+}
+
+void TimerService::schedule(TimerClient* client, qint64 deadline)
+{
+    auto i = m_clients.find(client);
+    if (i != m_clients.end())
+    {
+        m_deadlines.remove(i.value(), client);
+        i.value() = deadline;
+    }
+    else
+    {
+        m_clients.insert(client, deadline);
+    }
+    m_deadlines.insert(deadline, client);
+    rearm();
+}
+
+void TimerService::cancel(TimerClient* client)
+{
+    auto i = m_clients.find(client);
+    if (i == m_clients.end())
+        return;
+    m_deadlines.remove(i.value(), client);
+    m_clients.erase(i);
+    rearm();
+}
+
+int TimerService::pendingCount() const
+{
+    return m_clients.size();
+}
+
+void TimerService::onTimeout()
+{
+    qint64 current = now();
+    // collect expired clients first, as they can schedule
+    // themselves again from timerExpired()
+    QVarLengthArray<TimerClient*, 16> expired;
+    while (!m_deadlines.isEmpty() && m_deadlines.firstKey() <= current)
+    {
+        TimerClient* client = m_deadlines.first();
+        m_deadlines.erase(m_deadlines.begin());
+        m_clients.remove(client);
+        expired.append(client);
+    }
+    for (TimerClient* client : expired)
+        client->timerExpired();
+    rearm();
+}
+
+void TimerService::rearm()
+{
+    if (m_deadlines.isEmpty())
+    {
+        m_timer.stop();
+        return;
+    }
+    qint64 timeout = qMax<qint64>(0, m_deadlines.firstKey() - now());
+    m_timer.start(int(qMin<qint64>(timeout, std::numeric_limits<int>::max())));
+}
+
+ThrottleCallback::ThrottleCallback(Callback* target, int intervalMs,
+                                   TimerService* service)
+    : m_target(target)
+    , m_service(service)
+    , m_interval(intervalMs)
+    , m_last(std::numeric_limits<qint64>::min() / 2)
+    , m_hasPending(false)
+{}
+
+ThrottleCallback::~ThrottleCallback()
+{
+    m_service->cancel(this);
+}
+
+void ThrottleCallback::inputReady(QString data)
+{
+    qint64 now = m_service->now();
+    if (now - m_last < m_interval)
+    {
+        // suppressed, remember it for the end of interval
+        m_pending = std::move(data);
+        if (!m_hasPending)
+        {
+            m_hasPending = true;
+            m_service->schedule(this, m_last + m_interval);
+        }
+        return;
+    }
+    m_last = now;
+    m_target->inputReady(std::move(data));
+}
+
+void ThrottleCallback::timerExpired()
+{
+    if (!m_hasPending)
+        return;
+    m_hasPending = false;
+    m_last = m_service->now();
+    QString data;
+    data.swap(m_pending);
+    m_target->inputReady(std::move(data));
+}
+
+DebounceCallback::DebounceCallback(Callback* target, int delayMs,
+                                   TimerService* service)
+    : m_target(target)
+    , m_service(service)
+    , m_delay(delayMs)
+    , m_deadline(0)
+    , m_scheduled(false)
+{}
+
+DebounceCallback::~DebounceCallback()
+{
+    m_service->cancel(this);
+}
+
+void DebounceCallback::inputReady(QString data)
+{
+    m_pending = std::move(data);
+    m_deadline = m_service->now() + m_delay;
+    // timer isn't moved on every update, timerExpired()
+    // checks deadline and reschedules itself if needed
+    if (!m_scheduled)
+    {
+        m_scheduled = true;
+        m_service->schedule(this, m_deadline);
+    }
+}
+
+void DebounceCallback::timerExpired()
+{
+    if (m_service->now() < m_deadline)
+    {
+        m_service->schedule(this, m_deadline);
+        return;
+    }
+    m_scheduled = false;
+    QString data;
+    data.swap(m_pending);
+    m_target->inputReady(std::move(data));
+}
+
+SampleEveryNCallback::SampleEveryNCallback(Callback* target, int n)
+    : m_target(target)
+    , m_n(qMax(1, n))
+    , m_count(0)
+{}
+
+void SampleEveryNCallback::inputReady(QString data)
+{
+    if (++m_count < m_n)
+        return;
+    m_count = 0;
+    m_target->inputReady(std::move(data));
+}
@@ -0,0 +1,146 @@
+#ifndef RATE_LIMIT_H
+#define RATE_LIMIT_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMultiMap>
+#include <QString>
+#include <QTimer>
+
+#include "callbacks.h"
+
+/**
+ * Providers often send data much faster than receiver can use it
+ * (ex. user input or sensor updates). Here we have adapters that
+ * sit between provider and receiver: they are Callbacks themselves,
+ * and pass to target Callback only part of updates.
+ * Adapters can be chained: SampleEveryNCallback -> ThrottleCallback ->
+ * receiver. Adapters that need to deliver update later don't own
+ * timers, all of them share single TimerService.
+ * Adapters, their service and target must live in one thread,
+ * and adapter must not be deleted from inside of callback it calls.
+ */
+
+/**
+ * @brief The TimerClient class
+ * receives notification from TimerService.
+ */
+class TimerClient
+{
+public:
+    virtual ~TimerClient();
+    virtual void timerExpired() = 0;
+};
+
+/**
+ * @brief The TimerService class
+ * runs one QTimer for all clients, it's always armed
+ * for the earliest deadline.
+ */
+class TimerService
+{
+public:
+    TimerService();
+
+    /**
+     * @brief now
+     * @return milliseconds since service was created.
+     */
+    qint64 now() const;
+    /**
+     * @brief schedule calls client->timerExpired() at deadline
+     * (in terms of now()), replaces previous deadline of client.
+     * @param client
+     * @param deadline
+     */
+    void schedule(TimerClient* client, qint64 deadline);
+    /**
+     * @brief cancel removes client's deadline if any.
+     * @param client
+     */
+    void cancel(TimerClient* client);
+    /**
+     * @brief pendingCount
+     * @return number of scheduled clients.
+     */
+    int pendingCount() const;
+
+private:
+    Q_DISABLE_COPY(TimerService)
+
+    void onTimeout();
+    void rearm();
+
+    QElapsedTimer m_clock;
+    QTimer m_timer;
+    QMultiMap<qint64, TimerClient*> m_deadlines;
+    QHash<TimerClient*, qint64> m_clients;
+};
+
+/**
+ * @brief The ThrottleCallback class
+ * passes at most one update per interval. First update
+ * is passed immediately, the latest of suppressed updates
+ * is passed when interval ends.
+ */
+class ThrottleCallback : public Callback, private TimerClient
+{
+public:
+    ThrottleCallback(Callback* target, int intervalMs, TimerService* service);
+    ~ThrottleCallback();
+
+    void inputReady(QString data);
+
+private:
+    void timerExpired();
+
+    Callback* m_target;
+    TimerService* m_service;
+    qint64 m_interval;
+    qint64 m_last;
+    QString m_pending;
+    bool m_hasPending;
+};
+
+/**
+ * @brief The DebounceCallback class
+ * passes update only when no new updates came
+ * for delay, only the latest update is passed.
+ */
+class DebounceCallback : public Callback, private TimerClient
+{
+public:
+    DebounceCallback(Callback* target, int delayMs, TimerService* service);
+    ~DebounceCallback();
+
+    void inputReady(QString data);
+
+private:
+    void timerExpired();
+
+    Callback* m_target;
+    TimerService* m_service;
+    qint64 m_delay;
+    qint64 m_deadline;
+    QString m_pending;
+    bool m_scheduled;
+};
+
+/**
+ * @brief The SampleEveryNCallback class
+ * passes every n-th update (n-th, 2n-th, ...).
+ */
+class SampleEveryNCallback : public Callback
+{
+public:
+    SampleEveryNCallback(Callback* target, int n);
+
+    void inputReady(QString data);
+
+private:
+    Callback* m_target;
+    int m_n;
+    int m_count;
+};
+
+#endif // RATE_LIMIT_H
@@ -5,6 +5,10 @@ QT += testlib
 CONFIG += c++11
 CONFIG += rtti
 
+# trace bus deliveries and Signal emissions (see tracer.h),
+# without it tracer is only used explicitly
+DEFINES += QTKOANS_TRACE
+
 TARGET = signal_slot
 CONFIG += testcase
 CONFIG -= app_bundle
@@ -14,9 +18,41 @@ TEMPLATE = app
 SOURCES += signal_slot_koan.cpp \
     callbacks.cpp \
     message_bus.cpp \
-    signal_slot.cpp
+    signal_slot.cpp \
+    interned_string.cpp \
+    multi_callbacks.cpp \
+    handle_callbacks.cpp \
+    concurrent_callbacks.cpp \
+    delegate_callbacks.cpp \
+    batch_callbacks.cpp \
+    executor.cpp \
+    executor_callbacks.cpp \
+    rate_limit.cpp \
+    counter_graph.cpp \
+    atomic_counter.cpp \
+    counter_array.cpp \
+    tracer.cpp \
+    connection_group.cpp
 
 HEADERS += \
     callbacks.h \
     message_bus.h \
-    signal_slot.h
+    signal_slot.h \
+    interned_string.h \
+    multi_callbacks.h \
+    slot_map.h \
+    handle_callbacks.h \
+    concurrent_callbacks.h \
+    delegate.h \
+    delegate_callbacks.h \
+    batch_callbacks.h \
+    event_receiver.h \
+    executor.h \
+    executor_callbacks.h \
+    rate_limit.h \
+    fast_signal.h \
+    counter_graph.h \
+    atomic_counter.h \
+    counter_array.h \
+    tracer.h \
+    connection_group.h
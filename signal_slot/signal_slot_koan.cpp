@@ -1,9 +1,107 @@
 #include <QObject>
 #include <QTest>
 #include <QScopedPointer>
+#include <QStringList>
+#include <QStringBuilder>
+#include <QCoreApplication>
+#include <QThreadPool>
+#include <QSignalSpy>
+#include <QSet>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "callbacks.h"
 #include "message_bus.h"
+#include "interned_string.h"
+#include "multi_callbacks.h"
+#include "handle_callbacks.h"
+#include "concurrent_callbacks.h"
+#include "delegate_callbacks.h"
+#include "batch_callbacks.h"
+#include "event_receiver.h"
+#include "executor_callbacks.h"
+#include "rate_limit.h"
+#include "fast_signal.h"
+#include "counter_graph.h"
+#include "atomic_counter.h"
+#include "counter_array.h"
+#include "tracer.h"
+#include "connection_group.h"
+
+/**
+ * Allocation counter used to check how many allocations
+ * callbacks make. We replace malloc() for the whole test,
+ * counting calls only while counter is active in current thread.
+ * Qt containers allocate with malloc(), not with operator new.
+ * Replacement relies on __libc_malloc(), so it's compiled only
+ * with glibc, elsewhere malloc() is left alone and
+ * allocationsPerRecord is skipped.
+ */
+#if defined(__GLIBC__)
+#define ALLOCATION_COUNTER_SUPPORTED
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+
+static thread_local int* allocationCounter = NULL;
+
+extern "C" void* malloc(size_t size)
+{
+    if (allocationCounter != NULL)
+        ++(*allocationCounter);
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    if (allocationCounter != NULL)
+        ++(*allocationCounter);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size)
+{
+    if (allocationCounter != NULL)
+        ++(*allocationCounter);
+    return __libc_realloc(pointer, size);
+}
+
+/**
+ * @brief The AllocationCounter class
+ * counts allocations made by current thread while alive.
+ */
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+        : m_count(0)
+    {
+        allocationCounter = &m_count;
+    }
+
+    ~AllocationCounter()
+    {
+        allocationCounter = NULL;
+    }
+
+    int count() const
+    {
+        return m_count;
+    }
+
+private:
+    int m_count;
+};
+#endif
 
 class SignalSlotKoan : public QObject
 {
@@ -17,9 +115,25 @@ private slots:
     void basicCallback();
     void callCallback();
     void deleteCallback();
+    void multiCallback();
+    void handleCallback();
+    void concurrentCallback();
+    void delegateCallback();
+    void batchCallback();
+    void allocationsPerRecord();
+    void eventReceiver();
+    void executorCallback();
+    void rateLimitCallback();
+    void fastSignal();
+    void counterGraph();
+    void atomicCounter();
+    void counterArray();
+    void tracer();
+    void connectionGroup();
 
     void busSimple();
     void busDifferent();
+    void busInterned();
 };
 
 void SignalSlotKoan::initTestCase()
@@ -99,6 +213,1042 @@ void SignalSlotKoan::deleteCallback()
     QCOMPARE(provider.m_callback, reinterpret_cast<Callback*>(NULL));
 }
 
+/**
+ * @brief The RecordingCallback class
+ * callback used by tests of providers, that are
+ * not part of koan.
+ */
+class RecordingCallback : public Callback
+{
+public:
+    RecordingCallback()
+        : calls(0)
+    {}
+
+    void inputReady(QString data)
+    {
+        ++calls;
+        this->data = std::move(data);
+    }
+
+    int calls;
+    QString data;
+};
+
+void SignalSlotKoan::multiCallback()
+{
+    MultiInputDataProvider provider;
+    RecordingCallback receivers[MultiInputDataProvider::InlineCallbacks + 1];
+
+    provider.updateData(QString::fromLatin1("Name"),
+                        QString::fromLatin1("Surname"));
+    QCOMPARE(provider.m_data, QString::fromLatin1("Name Surname"));
+    QCOMPARE(provider.callbackCount(), 0);
+
+    for (RecordingCallback &receiver : receivers)
+    {
+        provider.setCallback(&receiver);
+        provider.setCallback(&receiver);
+    }
+    QCOMPARE(provider.callbackCount(),
+             (int)MultiInputDataProvider::InlineCallbacks + 1);
+
+    provider.updateData(QString::fromLatin1("John"),
+                        QString::fromLatin1("Jocoo"));
+    for (RecordingCallback &receiver : receivers)
+    {
+        QCOMPARE(receiver.calls, 1);
+        QCOMPARE(receiver.data, QString::fromLatin1("John Jocoo"));
+    }
+
+    provider.removeCallback(&receivers[1]);
+    QCOMPARE(provider.callbackCount(),
+             (int)MultiInputDataProvider::InlineCallbacks);
+    provider.updateData(QString::fromLatin1("Name"),
+                        QString::fromLatin1("Surname"));
+    QCOMPARE(receivers[0].calls, 2);
+    QCOMPARE(receivers[1].calls, 1);
+    QCOMPARE(receivers[1].data, QString::fromLatin1("John Jocoo"));
+    QCOMPARE(receivers[2].data, QString::fromLatin1("Name Surname"));
+}
+
+void SignalSlotKoan::handleCallback()
+{
+    QScopedPointer<HandleInputDataReceiver> receiver(new HandleInputDataReceiver());
+    QScopedPointer<HandleInputDataProvider> provider(new HandleInputDataProvider());
+    CallbackHandle receiverHandle = receiver->handle();
+    ProviderHandle providerHandle = provider->handle();
+
+    QCOMPARE(callbackSlots().get(receiverHandle), (Callback*)receiver.data());
+    QCOMPARE(providerSlots().get(providerHandle), provider.data());
+    QVERIFY(provider->m_callback.isNull());
+    QCOMPARE(receiver->provider(), (HandleInputDataProvider*)NULL);
+
+    receiver->setProvider(provider.data());
+    QCOMPARE(receiver->provider(), provider.data());
+    QVERIFY(provider->m_callback == receiverHandle);
+
+    provider->updateData(QString::fromLatin1("John"),
+                         QString::fromLatin1("Jocoo"));
+    QCOMPARE(receiver->m_data, QString::fromLatin1("John Jocoo"));
+
+    // receiver dies first, provider doesn't need to be notified
+    receiver.reset();
+    QCOMPARE(callbackSlots().get(receiverHandle), (Callback*)NULL);
+    provider->updateData(QString::fromLatin1("Name"),
+                         QString::fromLatin1("Surname"));
+    QCOMPARE(provider->m_data, QString::fromLatin1("Name Surname"));
+
+    // new receiver reuses slot, but old handle stays stale
+    receiver.reset(new HandleInputDataReceiver());
+    QVERIFY(receiver->handle() != receiverHandle);
+    QCOMPARE(callbackSlots().get(receiverHandle), (Callback*)NULL);
+
+    // provider dies first
+    receiver->setProvider(provider.data());
+    provider.reset();
+    QCOMPARE(receiver->provider(), (HandleInputDataProvider*)NULL);
+    QCOMPARE(providerSlots().get(providerHandle), (HandleInputDataProvider*)NULL);
+}
+
+/**
+ * @brief The StressCallback class
+ * counts calls that happened after it was removed
+ * from provider.
+ */
+class StressCallback : public Callback
+{
+public:
+    explicit StressCallback(std::atomic<int>* lateCalls)
+        : removed(false)
+        , m_lateCalls(lateCalls)
+    {}
+
+    void inputReady(QString)
+    {
+        if (removed.load())
+            ++(*m_lateCalls);
+    }
+
+    std::atomic<bool> removed;
+
+private:
+    std::atomic<int>* m_lateCalls;
+};
+
+/**
+ * @brief The BlockingCallback class
+ * stays inside of inputReady() until released.
+ */
+class BlockingCallback : public Callback
+{
+public:
+    BlockingCallback()
+        : entered(false)
+        , released(false)
+    {}
+
+    void inputReady(QString)
+    {
+        entered.store(true);
+        while (!released.load())
+            std::this_thread::yield();
+    }
+
+    std::atomic<bool> entered;
+    std::atomic<bool> released;
+};
+
+void SignalSlotKoan::concurrentCallback()
+{
+    const int notifiers = 4;
+    const int writers = 4;
+    const int iterations = 2000;
+
+    ConcurrentInputDataProvider provider;
+    std::atomic<int> lateCalls(0);
+    std::atomic<bool> stop(false);
+    StressCallback persistent(&lateCalls);
+    provider.setCallback(&persistent);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < notifiers; ++i)
+    {
+        threads.push_back(std::thread([&provider, &stop] () -> void
+        {
+            while (!stop.load())
+                provider.updateData(QString::fromLatin1("John"),
+                                    QString::fromLatin1("Jocoo"));
+        }));
+    }
+    std::vector<std::thread> churn;
+    for (int i = 0; i < writers; ++i)
+    {
+        churn.push_back(std::thread([&provider, &lateCalls, iterations] () -> void
+        {
+            for (int j = 0; j < iterations; ++j)
+            {
+                StressCallback* receiver = new StressCallback(&lateCalls);
+                provider.setCallback(receiver);
+                std::this_thread::yield();
+                provider.removeCallback(receiver);
+                // from now on receiver must never be called
+                receiver->removed.store(true);
+                delete receiver;
+            }
+        }));
+    }
+
+    for (std::thread &thread : churn)
+        thread.join();
+    stop.store(true);
+    for (std::thread &thread : threads)
+        thread.join();
+
+    provider.removeCallback(&persistent);
+    QCOMPARE(lateCalls.load(), 0);
+
+    // both threads removing the same callback wait for it,
+    // whichever of them actually removes it
+    BlockingCallback blocking;
+    provider.setCallback(&blocking);
+    std::thread notifier([&provider] () -> void
+    {
+        provider.updateData(QString::fromLatin1("John"),
+                            QString::fromLatin1("Jocoo"));
+    });
+    while (!blocking.entered.load())
+        std::this_thread::yield();
+    std::atomic<int> returned(0);
+    std::vector<std::thread> removers;
+    for (int i = 0; i < 2; ++i)
+    {
+        removers.push_back(std::thread([&provider, &blocking, &returned] () -> void
+        {
+            provider.removeCallback(&blocking);
+            ++returned;
+        }));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const int early = returned.load();
+    blocking.released.store(true);
+    notifier.join();
+    for (std::thread &thread : removers)
+        thread.join();
+    QCOMPARE(early, 0);
+    QCOMPARE(returned.load(), 2);
+}
+
+static QString delegateData;
+
+static void storeDelegateData(const QString &data)
+{
+    delegateData = data;
+}
+
+/**
+ * @brief The DelegateReceiver class
+ * receives data with plain method, no base class needed.
+ */
+class DelegateReceiver
+{
+public:
+    DelegateReceiver()
+        : calls(0)
+    {}
+
+    void inputReady(const QString &data)
+    {
+        ++calls;
+        this->data = data;
+    }
+
+    int calls;
+    QString data;
+};
+
+void SignalSlotKoan::delegateCallback()
+{
+    DelegateInputDataProvider provider;
+    provider.updateData(QString::fromLatin1("Name"),
+                        QString::fromLatin1("Surname"));
+    QCOMPARE(provider.m_data, QString::fromLatin1("Name Surname"));
+
+    provider.setCallback(InputDelegate::fromFunction<&storeDelegateData>());
+    provider.updateData(QString::fromLatin1("John"),
+                        QString::fromLatin1("Jocoo"));
+    QCOMPARE(delegateData, QString::fromLatin1("John Jocoo"));
+
+    DelegateReceiver receiver;
+    provider.setCallback(InputDelegate::fromMethod<DelegateReceiver,
+                         &DelegateReceiver::inputReady>(&receiver));
+    provider.updateData(QString::fromLatin1("Name"),
+                        QString::fromLatin1("Surname"));
+    QCOMPARE(receiver.calls, 1);
+    QCOMPARE(receiver.data, QString::fromLatin1("Name Surname"));
+
+    QString* lambdaData = &receiver.data;
+    provider.setCallback(InputDelegate::fromFunctor(
+                             [lambdaData] (const QString &data) -> void
+    {
+        *lambdaData = data.toUpper();
+    }));
+    provider.updateData(QString::fromLatin1("John"),
+                        QString::fromLatin1("Jocoo"));
+    QCOMPARE(receiver.calls, 1);
+    QCOMPARE(receiver.data, QString::fromLatin1("JOHN JOCOO"));
+
+    provider.setCallback(InputDelegate());
+    provider.updateData(QString::fromLatin1("Name"),
+                        QString::fromLatin1("Surname"));
+    QCOMPARE(receiver.data, QString::fromLatin1("JOHN JOCOO"));
+}
+
+/**
+ * @brief The RecordingBatchCallback class
+ * copies records of every received batch.
+ */
+class RecordingBatchCallback : public BatchCallback
+{
+public:
+    RecordingBatchCallback()
+        : calls(0)
+    {}
+
+    void inputBatchReady(const InputBatch &batch)
+    {
+        ++calls;
+        records.clear();
+        for (int i = 0; i < batch.size(); ++i)
+            records.append(batch.at(i).toString());
+    }
+
+    int calls;
+    QStringList records;
+};
+
+void SignalSlotKoan::batchCallback()
+{
+    BatchInputDataProvider provider;
+    RecordingBatchCallback receiver;
+    QVector<NameRecord> records;
+    records << NameRecord(QString::fromLatin1("John"), QString::fromLatin1("Jocoo"))
+            << NameRecord(QString::fromLatin1("Name"), QString::fromLatin1("Surname"))
+            << NameRecord(QString(), QString::fromLatin1("Smith"));
+
+    provider.updateData(records);
+    QCOMPARE(provider.batch().size(), 3);
+    QCOMPARE(receiver.calls, 0);
+
+    provider.setCallback(&receiver);
+    provider.updateData(records);
+    QCOMPARE(receiver.calls, 1);
+    QCOMPARE(receiver.records, QStringList()
+             << QString::fromLatin1("John Jocoo")
+             << QString::fromLatin1("Name Surname")
+             << QString::fromLatin1(" Smith"));
+    QCOMPARE(provider.batch().buffer(),
+             QString::fromLatin1("John JocooName Surname Smith"));
+
+    // buffer is reused by the next batch
+    const QChar* buffer = provider.batch().buffer().constData();
+    provider.updateData(records.constData(), records.constData() + 1);
+    QCOMPARE(receiver.calls, 2);
+    QCOMPARE(receiver.records, QStringList(QString::fromLatin1("John Jocoo")));
+    QCOMPARE(provider.batch().buffer().constData(), buffer);
+
+    provider.updateData(records.constData(), records.constData());
+    QCOMPARE(receiver.calls, 2);
+    QVERIFY(provider.batch().isEmpty());
+}
+
+void SignalSlotKoan::allocationsPerRecord()
+{
+#if defined(ALLOCATION_COUNTER_SUPPORTED)
+    MultiInputDataProvider provider;
+    RecordingCallback receivers[2];
+    provider.setCallback(&receivers[0]);
+    provider.setCallback(&receivers[1]);
+    QString name = QString::fromLatin1("John");
+    QString surname = QString::fromLatin1("Jocoo");
+
+    // QStringBuilder allocates result once, with exact size
+    int count;
+    {
+        AllocationCounter counter;
+        provider.updateData(name, surname);
+        count = counter.count();
+    }
+    qDebug("updateData(name, surname): %d allocation(s) per call", count);
+    QCOMPARE(count, 1);
+    {
+        AllocationCounter counter;
+        provider.updateData(name % QLatin1Char(' ') % surname);
+        count = counter.count();
+    }
+    qDebug("updateData(name %% ' ' %% surname): %d allocation(s) per call",
+           count);
+    QCOMPARE(count, 1);
+    // moved record is shared by provider and receivers
+    {
+        QString record = name % QLatin1Char(' ') % surname;
+        AllocationCounter counter;
+        provider.updateData(std::move(record));
+        count = counter.count();
+    }
+    qDebug("updateData(std::move(record)): %d allocation(s) per call", count);
+    QCOMPARE(count, 0);
+    QCOMPARE(receivers[1].data, QString::fromLatin1("John Jocoo"));
+    QCOMPARE(receivers[0].data.constData(), provider.m_data.constData());
+#else
+    QSKIP("allocation counter is supported only with glibc");
+#endif
+}
+
+/**
+ * @brief The InputAndClickReceiver class
+ * receives two kinds of events without a single virtual function.
+ */
+class InputAndClickReceiver : public Receiver<InputAndClickReceiver,
+                                              InputEvent, MouseClickEvent>
+{
+public:
+    InputAndClickReceiver()
+        : x(0)
+        , y(0)
+    {}
+
+    void onEvent(const InputEvent &event)
+    {
+        data = event.data;
+    }
+
+    void onEvent(const MouseClickEvent &event)
+    {
+        if (event.button != 1)
+            return;
+        x = event.x;
+        y = event.y;
+    }
+
+    QString data;
+    int x;
+    int y;
+};
+
+void SignalSlotKoan::eventReceiver()
+{
+    QVERIFY(!std::is_polymorphic<InputAndClickReceiver>::value);
+    QCOMPARE(sizeof(InputAndClickReceiver), sizeof(QString) + 2 * sizeof(int));
+
+    EventProvider<InputEvent> inputProvider;
+    EventProvider<MouseClickEvent> clickProvider;
+    InputAndClickReceiver receiver;
+
+    InputEvent input;
+    input.data = QString::fromLatin1("Hello there");
+    inputProvider.sendEvent(input);
+    QCOMPARE(receiver.data, QString());
+
+    receiver.connectTo(inputProvider);
+    receiver.connectTo(clickProvider);
+    QVERIFY(inputProvider.hasReceiver());
+    QVERIFY(clickProvider.hasReceiver());
+
+    inputProvider.sendEvent(input);
+    QCOMPARE(receiver.data, QString::fromLatin1("Hello there"));
+
+    MouseClickEvent click = { 56, 198, 0 };
+    clickProvider.sendEvent(click);
+    QCOMPARE(receiver.x, 0);
+    click.button = 1;
+    clickProvider.sendEvent(click);
+    QCOMPARE(receiver.x, 56);
+    QCOMPARE(receiver.y, 198);
+
+    // another receiver can't detach this one
+    InputAndClickReceiver other;
+    QVERIFY(!other.disconnectFrom(inputProvider));
+    QVERIFY(inputProvider.hasReceiver());
+    other.connectTo(clickProvider);
+    QVERIFY(!receiver.disconnectFrom(clickProvider));
+    clickProvider.sendEvent(click);
+    QCOMPARE(other.x, 56);
+
+    QVERIFY(receiver.disconnectFrom(inputProvider));
+    QVERIFY(!inputProvider.hasReceiver());
+    QVERIFY(!receiver.disconnectFrom(inputProvider));
+    QVERIFY(other.disconnectFrom(clickProvider));
+    QVERIFY(!clickProvider.hasReceiver());
+}
+
+/**
+ * @brief The OrderCallback class
+ * records data and notices if inputReady() is called
+ * from two threads at once.
+ */
+class OrderCallback : public Callback
+{
+public:
+    OrderCallback()
+        : inside(0)
+        , overlapped(false)
+    {}
+
+    void inputReady(QString data)
+    {
+        if (inside.fetch_add(1) != 0)
+            overlapped = true;
+        received.append(std::move(data));
+        std::this_thread::yield();
+        inside.fetch_sub(1);
+    }
+
+    std::atomic<int> inside;
+    std::atomic<bool> overlapped;
+    QStringList received;
+};
+
+void SignalSlotKoan::executorCallback()
+{
+    ExecutorInputDataProvider provider;
+    InlineExecutor inlineExecutor;
+    MailboxExecutor mailbox;
+    RecordingCallback direct;
+    RecordingCallback queued;
+    provider.addReceiver(&direct, &inlineExecutor);
+    provider.addReceiver(&queued, &mailbox);
+
+    std::thread worker([&provider] () -> void
+    {
+        provider.updateData(QString::fromLatin1("Name"),
+                            QString::fromLatin1("Surname"));
+        provider.updateData(QString::fromLatin1("John"),
+                            QString::fromLatin1("Smith"));
+        provider.updateData(QString::fromLatin1("John"),
+                            QString::fromLatin1("Jocoo"));
+    });
+    worker.join();
+    QCOMPARE(direct.calls, 3);
+    QCOMPARE(queued.calls, 0);
+
+    // the whole burst is delivered by one task in our thread
+    QCOMPARE(mailbox.runPending(), 1);
+    QCOMPARE(queued.calls, 3);
+    QCOMPARE(queued.data, QString::fromLatin1("John Jocoo"));
+    QCOMPARE(mailbox.runPending(), 0);
+
+    // posted, but not delivered data is dropped for removed receiver
+    provider.updateData(QString::fromLatin1("Name"),
+                        QString::fromLatin1("Surname"));
+    provider.removeReceiver(&queued);
+    QCOMPARE(mailbox.runPending(), 1);
+    QCOMPARE(queued.calls, 3);
+    QCOMPARE(direct.calls, 4);
+    provider.removeReceiver(&direct);
+
+    // mailbox scheduled in event loop of context
+    QObject context;
+    MailboxExecutor eventLoopMailbox(&context);
+    provider.addReceiver(&queued, &eventLoopMailbox);
+    provider.updateData(QString::fromLatin1("Event"),
+                        QString::fromLatin1("Loop"));
+    QCOMPARE(queued.calls, 3);
+    QCoreApplication::processEvents();
+    QCOMPARE(queued.calls, 4);
+    QCOMPARE(queued.data, QString::fromLatin1("Event Loop"));
+    provider.removeReceiver(&queued);
+
+    QThreadPool pool;
+    ThreadPoolExecutor poolExecutor(&pool);
+    RecordingCallback pooled;
+    provider.addReceiver(&pooled, &poolExecutor);
+    provider.updateData(QString::fromLatin1("Thread"),
+                        QString::fromLatin1("Pool"));
+    pool.waitForDone();
+    QCOMPARE(pooled.calls, 1);
+    QCOMPARE(pooled.data, QString::fromLatin1("Thread Pool"));
+    provider.removeReceiver(&pooled);
+
+    // pool never runs receiver concurrently and keeps order
+    pool.setMaxThreadCount(4);
+    OrderCallback ordered;
+    provider.addReceiver(&ordered, &poolExecutor);
+    const int updates = 2000;
+    for (int i = 0; i < updates; ++i)
+        provider.updateData(QString::number(i), QString());
+    pool.waitForDone();
+    QVERIFY(!ordered.overlapped);
+    QCOMPARE(ordered.received.size(), updates);
+    for (int i = 0; i < updates; ++i)
+        QCOMPARE(ordered.received.at(i), QString::number(i) + QLatin1Char(' '));
+    provider.removeReceiver(&ordered);
+}
+
+void SignalSlotKoan::rateLimitCallback()
+{
+    TimerService service;
+    RecordingCallback throttled;
+    RecordingCallback debounced;
+    RecordingCallback sampled;
+    ThrottleCallback throttle(&throttled, 100, &service);
+    DebounceCallback debounce(&debounced, 50, &service);
+    SampleEveryNCallback sampleThrottle(&throttle, 3);
+    SampleEveryNCallback sample(&sampled, 3);
+
+    for (int i = 1; i <= 9; ++i)
+    {
+        QString data = QString::number(i);
+        throttle.inputReady(data);
+        debounce.inputReady(data);
+        sample.inputReady(data);
+    }
+
+    // first update passes throttle immediately
+    QCOMPARE(throttled.calls, 1);
+    QCOMPARE(throttled.data, QString::fromLatin1("1"));
+    QCOMPARE(debounced.calls, 0);
+    QCOMPARE(sampled.calls, 3);
+    QCOMPARE(sampled.data, QString::fromLatin1("9"));
+    // both adapters share one timer
+    QCOMPARE(service.pendingCount(), 2);
+
+    QTRY_COMPARE(debounced.calls, 1);
+    QCOMPARE(debounced.data, QString::fromLatin1("9"));
+    QTRY_COMPARE(throttled.calls, 2);
+    QCOMPARE(throttled.data, QString::fromLatin1("9"));
+    QCOMPARE(service.pendingCount(), 0);
+
+    // chained adapters: every 3rd update goes to throttle
+    for (int i = 10; i <= 12; ++i)
+        sampleThrottle.inputReady(QString::number(i));
+    QTRY_COMPARE(throttled.calls, 3);
+    QCOMPARE(throttled.data, QString::fromLatin1("12"));
+}
+
+/**
+ * @brief The FastSignalReceiver class
+ * QObject without any slots, receives Signal<int>.
+ */
+class FastSignalReceiver : public QObject
+{
+public:
+    FastSignalReceiver()
+        : value(0)
+        , calls(0)
+    {}
+
+    void setValue(int value)
+    {
+        this->value = value;
+        ++calls;
+    }
+
+    int watchers() const
+    {
+        return receivers(SIGNAL(destroyed(QObject*)));
+    }
+
+    int value;
+    int calls;
+};
+
+void SignalSlotKoan::fastSignal()
+{
+    Signal<int> valueChanged;
+    FastSignalReceiver receiver1;
+    FastSignalReceiver receiver2;
+
+    Signal<int>::Connection connection1 = valueChanged.connect<FastSignalReceiver,
+            &FastSignalReceiver::setValue>(&receiver1);
+    {
+        Signal<int>::Connection connection2 = valueChanged.connect<FastSignalReceiver,
+                &FastSignalReceiver::setValue>(&receiver2);
+        QCOMPARE(valueChanged.slotCount(), 2);
+        valueChanged(5);
+        QCOMPARE(receiver1.value, 5);
+        QCOMPARE(receiver2.value, 5);
+    }
+    // connection2 is out of scope
+    QCOMPARE(valueChanged.slotCount(), 1);
+    valueChanged(7);
+    QCOMPARE(receiver1.value, 7);
+    QCOMPARE(receiver2.value, 5);
+
+    // connected for lifetime of QObject
+    FastSignalReceiver* receiver3 = new FastSignalReceiver();
+    valueChanged.connectObject<FastSignalReceiver,
+            &FastSignalReceiver::setValue>(receiver3);
+    valueChanged(9);
+    QCOMPARE(receiver3->value, 9);
+    QCOMPARE(receiver3->watchers(), 1);
+    delete receiver3;
+    QCOMPARE(valueChanged.slotCount(), 1);
+    valueChanged(11);
+    QCOMPARE(receiver1.value, 11);
+
+    // slot with context disconnected before context is destroyed
+    {
+        FastSignalReceiver context;
+        Signal<int>::Connection connection = valueChanged.connect(
+                    Signal<int>::Slot::fromMethod<FastSignalReceiver,
+                    &FastSignalReceiver::setValue>(&context), &context);
+        QCOMPARE(valueChanged.slotCount(), 2);
+        QCOMPARE(context.watchers(), 1);
+        connection.disconnect();
+        QCOMPARE(valueChanged.slotCount(), 1);
+        QCOMPARE(context.watchers(), 0);
+
+        // signal destroyed before context
+        {
+            Signal<int> shortLived;
+            shortLived.connectObject<FastSignalReceiver,
+                    &FastSignalReceiver::setValue>(&context);
+            QCOMPARE(context.watchers(), 1);
+        }
+        QCOMPARE(context.watchers(), 0);
+    }
+
+    // slot disconnects itself in the middle of emission
+    Signal<int>::Connection once;
+    Signal<int>::Connection* oncePointer = &once;
+    int* calls = &receiver2.calls;
+    once = valueChanged.connect(Signal<int>::Slot::fromFunctor(
+                                    [oncePointer, calls] (int) -> void
+    {
+        ++(*calls);
+        oncePointer->disconnect();
+    }));
+    int before = receiver2.calls;
+    valueChanged(13);
+    valueChanged(15);
+    QCOMPARE(receiver2.calls, before + 1);
+    QCOMPARE(valueChanged.slotCount(), 1);
+
+    connection1.disconnect();
+    QVERIFY(!connection1.isConnected());
+    QCOMPARE(valueChanged.slotCount(), 0);
+}
+
+void SignalSlotKoan::counterGraph()
+{
+    CounterGraph graph;
+    Counter a;
+    Counter b;
+    Counter c;
+    Counter d;
+
+    // diamond a -> b -> d, a -> c -> d
+    QVERIFY(graph.connect(&a, &b));
+    QVERIFY(graph.connect(&a, &c));
+    QVERIFY(graph.connect(&b, &d));
+    QVERIFY(graph.connect(&c, &d));
+    QVERIFY(!graph.connect(&c, &d));
+    // cycles are rejected
+    QVERIFY(!graph.connect(&d, &a));
+    QVERIFY(!graph.connect(&a, &a));
+
+    graph.setValue(&a, 5);
+    QVector<Counter*> order = graph.lastEvaluationOrder();
+    QCOMPARE(order.size(), 4);
+    QCOMPARE(order.first(), &a);
+    QCOMPARE(order.last(), &d);
+
+    // transaction: d is still evaluated once
+    graph.beginTransaction();
+    graph.setValue(&b, 6);
+    graph.setValue(&c, 7);
+    QVERIFY(graph.lastEvaluationOrder() == order);
+    graph.commit();
+    order = graph.lastEvaluationOrder();
+    QCOMPARE(order.size(), 3);
+    QCOMPARE(order.count(&d), 1);
+    QCOMPARE(order.last(), &d);
+    // both senders of d changed, c was connected to d last and wins
+    QCOMPARE(graph.lastChanges().value(&d), 7);
+    // the rule holds whichever order senders are evaluated in
+    for (int i = 0; i < 10; ++i)
+    {
+        graph.beginTransaction();
+        graph.setValue(&c, 100 + i);
+        graph.setValue(&b, 200 + i);
+        graph.commit();
+        QCOMPARE(graph.lastChanges().value(&d), 100 + i);
+    }
+    // direct value loses to value from sender
+    graph.beginTransaction();
+    graph.setValue(&d, 1);
+    graph.setValue(&b, 2);
+    graph.commit();
+    QCOMPARE(graph.lastChanges().value(&d), 2);
+    // reconnected b is now the last connected sender of d
+    QVERIFY(graph.disconnect(&b, &d));
+    QVERIFY(graph.connect(&b, &d));
+    graph.beginTransaction();
+    graph.setValue(&b, 3);
+    graph.setValue(&c, 4);
+    graph.commit();
+    QCOMPARE(graph.lastChanges().value(&d), 3);
+
+    // destroyed counters leave the graph
+    {
+        Counter e;
+        QVERIFY(graph.connect(&d, &e));
+        graph.setValue(&d, 8);
+        QCOMPARE(graph.lastEvaluationOrder().size(), 2);
+    }
+    graph.setValue(&d, 9);
+    QCOMPARE(graph.lastEvaluationOrder().size(), 1);
+    QVERIFY(graph.disconnect(&c, &d));
+    QVERIFY(!graph.disconnect(&c, &d));
+    QVERIFY(graph.connect(&d, &c));
+}
+
+void SignalSlotKoan::atomicCounter()
+{
+    const int writers = 4;
+    const int writes = 10000;
+
+    AtomicCounter counter;
+    QSignalSpy spy(&counter, SIGNAL(valueChanged(int)));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < writers; ++i)
+    {
+        threads.push_back(std::thread([&counter, i, writes] () -> void
+        {
+            for (int j = 1; j <= writes; ++j)
+                counter.setValue(i * writes + j);
+        }));
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    // writers never emit, notification waits for event loop
+    QCOMPARE(spy.count(), 0);
+    QCoreApplication::processEvents();
+    // all writes are coalesced into one notification
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.last().first().toInt(), counter.value());
+
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 1);
+
+    // setting the same value doesn't notify
+    counter.setValue(counter.value());
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 1);
+
+    counter.setValue(-1);
+    counter.setValue(-2);
+    QCoreApplication::processEvents();
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.last().first().toInt(), -2);
+}
+
+void SignalSlotKoan::counterArray()
+{
+    CounterArray counters(1000);
+    QSignalSpy spy(&counters, SIGNAL(valuesChanged(int,int)));
+
+    // single change outside of batch
+    counters.setValue(3, 7);
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.last().at(0).toInt(), 3);
+    QCOMPARE(spy.last().at(1).toInt(), 3);
+    counters.setValue(3, 7);
+    QCOMPARE(spy.count(), 1);
+
+    // thousand changes, one signal
+    counters.beginUpdate();
+    for (int i = 100; i < 900; ++i)
+        counters.setValue(i, i);
+    counters.beginUpdate();
+    counters.setValue(950, 1);
+    counters.endUpdate();
+    QCOMPARE(spy.count(), 1);
+    counters.endUpdate();
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.last().at(0).toInt(), 100);
+    QCOMPARE(spy.last().at(1).toInt(), 950);
+
+    // range is trimmed to values that really changed
+    QVector<int> values(10, 0);
+    values[4] = 4;
+    values[6] = 6;
+    counters.setValues(0, values.constData(), values.size());
+    QCOMPARE(spy.count(), 3);
+    QCOMPARE(spy.last().at(0).toInt(), 3);
+    QCOMPARE(spy.last().at(1).toInt(), 6);
+    QCOMPARE(counters.value(3), 0);
+    QCOMPARE(counters.constData()[6], 6);
+
+    counters.setValues(0, values.constData(), values.size());
+    QCOMPARE(spy.count(), 3);
+}
+
+void SignalSlotKoan::tracer()
+{
+    Counter a;
+    Counter b;
+    a.setObjectName(QStringLiteral("a"));
+    b.setObjectName(QStringLiteral("b"));
+    traceCounter(&a);
+    traceConnect(&a, &b);
+    Signal<int> valueChanged;
+#ifdef QTKOANS_TRACE
+    // Signal emission is traced only in builds with QTKOANS_TRACE
+    const int records = 4;
+#else
+    const int records = 3;
+#endif
+
+    // nothing is recorded while disabled
+    Tracer::clear();
+    emit a.valueChanged(1);
+    valueChanged(1);
+    QCOMPARE(Tracer::recordCount(), 0);
+
+    Tracer::setEnabled(true);
+    emit a.valueChanged(2);
+    valueChanged(2);
+    std::thread thread([] () -> void
+    {
+        static const InternedString name(QStringLiteral("worker"));
+        TraceScope scope(name);
+    });
+    thread.join();
+    Tracer::setEnabled(false);
+    QCOMPARE(Tracer::recordCount(), records);
+
+    QJsonDocument document = QJsonDocument::fromJson(Tracer::toChromeTrace());
+    QJsonArray events = document.object().value(QStringLiteral("traceEvents")).toArray();
+    QCOMPARE(events.size(), records);
+    QStringList names;
+    QSet<int> threads;
+    for (const QJsonValue &value : events)
+    {
+        QJsonObject event = value.toObject();
+        names << event.value(QStringLiteral("name")).toString();
+        threads << event.value(QStringLiteral("tid")).toInt();
+        if (event.value(QStringLiteral("ph")).toString() == QLatin1String("X"))
+            QVERIFY(event.value(QStringLiteral("dur")).toDouble() >= 0.0);
+    }
+    QVERIFY(names.contains(QStringLiteral("a::valueChanged")));
+    QVERIFY(names.contains(QStringLiteral("a -> b")));
+    QCOMPARE(names.contains(QStringLiteral("Signal::emit")), records == 4);
+    QVERIFY(names.contains(QStringLiteral("worker")));
+    QCOMPARE(threads.size(), 2);
+
+    // buffers of finished threads are reused
+    Tracer::setEnabled(true);
+    const int buffers = Tracer::bufferCount();
+    for (int i = 0; i < 8; ++i)
+    {
+        std::thread worker([] () -> void
+        {
+            static const InternedString name(QStringLiteral("short-lived"));
+            TraceScope scope(name);
+        });
+        worker.join();
+    }
+    Tracer::setEnabled(false);
+    QCOMPARE(Tracer::bufferCount(), buffers);
+
+    Tracer::clear();
+    QCOMPARE(Tracer::recordCount(), 0);
+}
+
+/**
+ * @brief The ObservedCounter class
+ * tells how many connections its valueChanged() and destroyed() have,
+ * so connections can be checked without setValue() koan.
+ */
+class ObservedCounter : public Counter
+{
+public:
+    int connections() const
+    {
+        return receivers(SIGNAL(valueChanged(int)));
+    }
+
+    int watchers() const
+    {
+        return receivers(SIGNAL(destroyed(QObject*)));
+    }
+};
+
+void SignalSlotKoan::connectionGroup()
+{
+    const int count = 1000;
+    ObservedCounter sender;
+    QVector<Counter*> receivers;
+    for (int i = 0; i < count; ++i)
+        receivers.append(new Counter());
+
+    {
+        ConnectionGroup group;
+        QCOMPARE(group.connect(&sender, receivers), count);
+        // duplicates are skipped
+        QCOMPARE(group.connect(&sender, receivers), 0);
+        QVERIFY(!group.connect(&sender, receivers.first()));
+        QCOMPARE(group.size(), count);
+        QCOMPARE(sender.connections(), count);
+
+        QVERIFY(group.disconnect(&sender, receivers.first()));
+        QVERIFY(!group.disconnect(&sender, receivers.first()));
+        QVERIFY(!group.contains(&sender, receivers.first()));
+        QVERIFY(group.contains(&sender, receivers.last()));
+        QCOMPARE(group.size(), count - 1);
+        QCOMPARE(sender.connections(), count - 1);
+
+        // destroyed receiver is dropped from group
+        Counter* destroyed = receivers.takeLast();
+        delete destroyed;
+        QCOMPARE(group.size(), count - 2);
+        QCOMPARE(sender.connections(), count - 2);
+        QVERIFY(!group.contains(&sender, destroyed));
+
+        // destroyed sender drops all its connections
+        {
+            ObservedCounter other;
+            QCOMPARE(group.connect(&other, receivers), receivers.size());
+            QCOMPARE(group.size(), count - 2 + receivers.size());
+        }
+        QCOMPARE(group.size(), count - 2);
+
+        // reconnect after disconnect
+        QVERIFY(group.connect(&sender, receivers.first()));
+        QCOMPARE(sender.connections(), count - 1);
+        QCOMPARE(sender.watchers(), 1);
+
+        // Counter without links isn't watched anymore
+        ObservedCounter a;
+        ObservedCounter b;
+        for (int i = 0; i < 100; ++i)
+        {
+            QVERIFY(group.connect(&a, &b));
+            QVERIFY(group.connect(&a, &a));
+            QVERIFY(group.connect(&b, &a));
+            QCOMPARE(a.watchers(), 1);
+            QCOMPARE(b.watchers(), 1);
+            QVERIFY(group.disconnect(&a, &b));
+            QVERIFY(group.contains(&a, &a));
+            QVERIFY(group.contains(&b, &a));
+            QVERIFY(group.disconnect(&b, &a));
+            QCOMPARE(b.watchers(), 0);
+            QVERIFY(group.disconnect(&a, &a));
+            QCOMPARE(a.watchers(), 0);
+        }
+        QCOMPARE(a.connections(), 0);
+        QCOMPARE(group.size(), count - 1);
+    }
+
+    // group disconnects everything when destroyed
+    QCOMPARE(sender.connections(), 0);
+    qDeleteAll(receivers);
+}
+
 extern void deliverMessages();
 extern std::vector<MessageReceiver*> __receivers;
 extern std::vector<MessageBase*> __messages;
@@ -193,5 +1343,27 @@ void SignalSlotKoan::busDifferent()
     QCOMPARE(__messages.size(), (size_t)0);
 }
 
+void SignalSlotKoan::busInterned()
+{
+    InternedString hello(QString::fromLatin1("hello"));
+    InternedString hello2(QString::fromLatin1("hel") + QString::fromLatin1("lo"));
+    InternedString bye(QString::fromLatin1("bye"));
+    QVERIFY(hello == hello2);
+    QVERIFY(hello != bye);
+    QVERIFY(InternedString().isNull());
+    QVERIFY(!hello.isNull());
+    QCOMPARE(&hello.toString(), &hello2.toString());
+    QCOMPARE(hello.toString(), QString::fromLatin1("hello"));
+
+    MessageBase interned(UserInput, hello);
+    QVERIFY(interned.atom() == hello);
+    QCOMPARE(&interned.messageView(), &hello.toString());
+    QCOMPARE(interned.message(), QString::fromLatin1("hello"));
+
+    MessageBase plain(UserInput, QString::fromLatin1("hello"));
+    QVERIFY(plain.atom().isNull());
+    QCOMPARE(plain.messageView(), QString::fromLatin1("hello"));
+}
+
 QTEST_MAIN(SignalSlotKoan)
 #include "signal_slot_koan.moc"
@@ -0,0 +1,164 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <QVector>
+
+/**
+ * Slot map is a container that gives you a handle instead of
+ * a pointer. Handle consists of index of slot and generation
+ * of that slot. Each time object is removed from slot, generation
+ * of slot is incremented, so all handles that were given out earlier
+ * become stale. Checking if handle is still alive costs one
+ * integer compare, and nobody needs to be notified about deletion.
+ * Removed slots are reused, so memory doesn't grow when objects are
+ * created and deleted over and over.
+ */
+
+/**
+ * @brief The SlotHandle class
+ * is a weak reference to object stored in SlotMap<T>.
+ * Default constructed handle is null and never
+ * refers to any object.
+ */
+template <class T>
+class SlotHandle
+{
+public:
+    SlotHandle()
+        : m_index(0)
+        , m_generation(0)
+    {}
+
+    bool isNull() const
+    {
+        return m_generation == 0;
+    }
+
+    bool operator==(const SlotHandle &other) const
+    {
+        return m_index == other.m_index && m_generation == other.m_generation;
+    }
+
+    bool operator!=(const SlotHandle &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    SlotHandle(quint32 index, quint32 generation)
+        : m_index(index)
+        , m_generation(generation)
+    {}
+
+    quint32 m_index;
+    quint32 m_generation;
+
+    template <class U> friend class SlotMap;
+};
+
+/**
+ * @brief The SlotMap class
+ * stores pointers to objects and hands out
+ * generation checked handles to them.
+ * It's not thread safe.
+ */
+template <class T>
+class SlotMap
+{
+public:
+    typedef SlotHandle<T> Handle;
+
+    SlotMap()
+        : m_freeHead(NoFreeSlot)
+        , m_size(0)
+    {}
+
+    /**
+     * @brief insert stores object in free slot.
+     * @param object
+     * @return handle to object.
+     */
+    Handle insert(T* object)
+    {
+        quint32 index;
+        if (m_freeHead != NoFreeSlot)
+        {
+            index = m_freeHead;
+            m_freeHead = m_slots[index].nextFree;
+        }
+        else
+        {
+            index = m_slots.size();
+            // generation 0 is reserved for null handle
+            m_slots.append(Slot());
+            m_slots.last().generation = 1;
+        }
+        Slot &slot = m_slots[index];
+        slot.object = object;
+        slot.nextFree = NoFreeSlot;
+        ++m_size;
+        return Handle(index, slot.generation);
+    }
+
+    /**
+     * @brief remove frees slot, all handles to it become stale.
+     * Removing stale handle does nothing.
+     * @param handle
+     */
+    void remove(Handle handle)
+    {
+        if (get(handle) == NULL)
+            return;
+        Slot &slot = m_slots[handle.m_index];
+        slot.object = NULL;
+        if (++slot.generation == 0)
+            slot.generation = 1;
+        slot.nextFree = m_freeHead;
+        m_freeHead = handle.m_index;
+        --m_size;
+    }
+
+    /**
+     * @brief get
+     * @param handle
+     * @return object, or NULL if handle is null or stale.
+     */
+    T* get(Handle handle) const
+    {
+        if (handle.m_index >= quint32(m_slots.size()))
+            return NULL;
+        const Slot &slot = m_slots.at(handle.m_index);
+        return slot.generation == handle.m_generation ? slot.object : NULL;
+    }
+
+    /**
+     * @brief size
+     * @return number of alive objects.
+     */
+    int size() const
+    {
+        return m_size;
+    }
+
+private:
+    enum : quint32 { NoFreeSlot = 0xffffffff };
+
+    struct Slot
+    {
+        Slot()
+            : object(NULL)
+            , generation(0)
+            , nextFree(NoFreeSlot)
+        {}
+
+        T* object;
+        quint32 generation;
+        quint32 nextFree;
+    };
+
+    QVector<Slot> m_slots;
+    quint32 m_freeHead;
+    int m_size;
+};
+
+#endif // SLOT_MAP_H
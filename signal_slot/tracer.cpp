@@ -0,0 +1,334 @@
+#include "tracer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "signal_slot.h"
+
+typedef std::lock_guard<std::mutex> guard;
+
+namespace
+{
+
+std::atomic<bool> s_enabled(false);
+
+qint64 now()
+{
+    static const std::chrono::steady_clock::time_point epoch =
+            std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - epoch).count();
+}
+
+/**
+ * Fields are atomic (relaxed), as exporting thread
+ * can read record while owner overwrites it, such records
+ * are detected by head index and dropped.
+ */
+struct TraceRecord
+{
+    std::atomic<const QString*> name;
+    std::atomic<qint64> begin;
+    // -1 for instant
+    std::atomic<qint64> duration;
+};
+
+struct ExportedRecord
+{
+    const QString* name;
+    qint64 begin;
+    qint64 duration;
+};
+
+/**
+ * Ring buffer with single writer (owner thread).
+ * Records [max(tail, head - Capacity), head) are valid.
+ */
+class TraceBuffer
+{
+public:
+    enum { Capacity = 1 << 14 };
+
+    TraceBuffer()
+        : m_threadId(0)
+        , m_head(0)
+        , m_tail(0)
+    {}
+
+    int threadId() const
+    {
+        return m_threadId.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief reuse gives buffer to new thread,
+     * records of previous one are dropped.
+     * @param threadId
+     */
+    void reuse(int threadId)
+    {
+        clear();
+        m_threadId.store(threadId, std::memory_order_relaxed);
+    }
+
+    void append(const QString* name, qint64 begin, qint64 duration)
+    {
+        const quint64 head = m_head.load(std::memory_order_relaxed);
+        TraceRecord &record = m_records[head & (Capacity - 1)];
+        record.name.store(name, std::memory_order_relaxed);
+        record.begin.store(begin, std::memory_order_relaxed);
+        record.duration.store(duration, std::memory_order_relaxed);
+        m_head.store(head + 1, std::memory_order_release);
+    }
+
+    void clear()
+    {
+        m_tail.store(m_head.load(std::memory_order_acquire),
+                     std::memory_order_release);
+    }
+
+    void read(std::vector<ExportedRecord> &out) const
+    {
+        const quint64 head = m_head.load(std::memory_order_acquire);
+        quint64 first = oldest(head);
+        std::vector<ExportedRecord> records;
+        records.reserve(head - first);
+        for (quint64 i = first; i < head; ++i)
+        {
+            const TraceRecord &record = m_records[i & (Capacity - 1)];
+            ExportedRecord exported;
+            exported.name = record.name.load(std::memory_order_relaxed);
+            exported.begin = record.begin.load(std::memory_order_relaxed);
+            exported.duration = record.duration.load(std::memory_order_relaxed);
+            records.push_back(exported);
+        }
+        // writer could overwrite records while we were reading,
+        // record it writes now (at current head) is also suspicious
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const quint64 current = m_head.load(std::memory_order_relaxed);
+        const quint64 valid = current + 1 > Capacity ? current + 1 - Capacity : 0;
+        for (quint64 i = first; i < head; ++i)
+        {
+            if (i >= valid)
+                out.push_back(records[i - first]);
+        }
+    }
+
+    int size() const
+    {
+        const quint64 head = m_head.load(std::memory_order_acquire);
+        return int(head - oldest(head));
+    }
+
+private:
+    quint64 oldest(quint64 head) const
+    {
+        const quint64 tail = m_tail.load(std::memory_order_acquire);
+        const quint64 overwritten = head > Capacity ? head - Capacity : 0;
+        return std::max(tail, overwritten);
+    }
+
+    std::atomic<int> m_threadId;
+    std::atomic<quint64> m_head;
+    std::atomic<quint64> m_tail;
+    TraceRecord m_records[Capacity];
+};
+
+std::mutex s_buffersMutex;
+// every buffer ever created, records of finished thread
+// stay exportable until its buffer is reused
+std::vector<std::shared_ptr<TraceBuffer>> s_buffers;
+// buffers of finished threads
+std::vector<TraceBuffer*> s_freeBuffers;
+int s_lastThreadId = 0;
+
+/**
+ * @brief The ThreadBuffer class
+ * takes buffer for current thread and returns it to free list
+ * when thread exits, so number of buffers is limited by number
+ * of threads tracing at the same time, not by number of threads
+ * that ever traced (thread pools, short-lived threads).
+ */
+class ThreadBuffer
+{
+public:
+    ThreadBuffer()
+    {
+        guard g(s_buffersMutex);
+        if (s_freeBuffers.empty())
+        {
+            s_buffers.push_back(std::make_shared<TraceBuffer>());
+            m_buffer = s_buffers.back().get();
+        }
+        else
+        {
+            m_buffer = s_freeBuffers.back();
+            s_freeBuffers.pop_back();
+        }
+        m_buffer->reuse(++s_lastThreadId);
+    }
+
+    ~ThreadBuffer()
+    {
+        guard g(s_buffersMutex);
+        s_freeBuffers.push_back(m_buffer);
+    }
+
+    TraceBuffer* buffer() const
+    {
+        return m_buffer;
+    }
+
+private:
+    TraceBuffer* m_buffer;
+};
+
+TraceBuffer* threadBuffer()
+{
+    // created on first use, so threads that don't trace
+    // don't take buffer
+    thread_local ThreadBuffer buffer;
+    return buffer.buffer();
+}
+
+std::vector<std::shared_ptr<TraceBuffer>> buffers()
+{
+    guard g(s_buffersMutex);
+    return s_buffers;
+}
+
+QString displayName(const QObject* object)
+{
+    if (!object->objectName().isEmpty())
+        return object->objectName();
+    return QString::fromLatin1("0x%1").arg(quintptr(object), 0, 16);
+}
+
+} // namespace
+
+bool Tracer::isEnabled()
+{
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::setEnabled(bool enabled)
+{
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::instant(const InternedString &name)
+{
+    if (!isEnabled())
+        return;
+    threadBuffer()->append(&name.toString(), now(), -1);
+}
+
+void Tracer::clear()
+{
+    for (const std::shared_ptr<TraceBuffer> &buffer : buffers())
+        buffer->clear();
+}
+
+int Tracer::bufferCount()
+{
+    guard g(s_buffersMutex);
+    return int(s_buffers.size());
+}
+
+int Tracer::recordCount()
+{
+    int count = 0;
+    for (const std::shared_ptr<TraceBuffer> &buffer : buffers())
+        count += buffer->size();
+    return count;
+}
+
+QByteArray Tracer::toChromeTrace()
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray events;
+    std::vector<ExportedRecord> records;
+    for (const std::shared_ptr<TraceBuffer> &buffer : buffers())
+    {
+        records.clear();
+        buffer->read(records);
+        for (const ExportedRecord &record : records)
+        {
+            QJsonObject event;
+            event.insert(QStringLiteral("name"), *record.name);
+            event.insert(QStringLiteral("cat"), QStringLiteral("signal_slot"));
+            event.insert(QStringLiteral("pid"), pid);
+            event.insert(QStringLiteral("tid"), buffer->threadId());
+            // trace event format uses microseconds
+            event.insert(QStringLiteral("ts"), record.begin / 1000.0);
+            if (record.duration < 0)
+            {
+                event.insert(QStringLiteral("ph"), QStringLiteral("i"));
+                event.insert(QStringLiteral("s"), QStringLiteral("t"));
+            }
+            else
+            {
+                event.insert(QStringLiteral("ph"), QStringLiteral("X"));
+                event.insert(QStringLiteral("dur"), record.duration / 1000.0);
+            }
+            events.append(event);
+        }
+    }
+    QJsonObject root;
+    root.insert(QStringLiteral("traceEvents"), events);
+    root.insert(QStringLiteral("displayTimeUnit"), QStringLiteral("ns"));
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Tracer::writeChromeTrace(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    const QByteArray json = toChromeTrace();
+    return file.write(json) == json.size();
+}
+
+TraceScope::TraceScope(const InternedString &name)
+    : m_name(name)
+    , m_begin(Tracer::isEnabled() ? now() : -1)
+{}
+
+TraceScope::~TraceScope()
+{
+    if (m_begin < 0)
+        return;
+    threadBuffer()->append(&m_name.toString(), m_begin, now() - m_begin);
+}
+
+QMetaObject::Connection traceCounter(Counter* counter)
+{
+    const InternedString name(displayName(counter) +
+                              QStringLiteral("::valueChanged"));
+    return QObject::connect(counter, &Counter::valueChanged,
+                            [name] (int) -> void
+    {
+        Tracer::instant(name);
+    });
+}
+
+QMetaObject::Connection traceConnect(Counter* sender, Counter* receiver)
+{
+    const InternedString name(displayName(sender) + QStringLiteral(" -> ") +
+                              displayName(receiver));
+    return QObject::connect(sender, &Counter::valueChanged, receiver,
+                            [receiver, name] (int value) -> void
+    {
+        TraceScope scope(name);
+        receiver->setValue(value);
+    });
+}
@@ -0,0 +1,111 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QByteArray>
+#include <QMetaObject>
+#include <QString>
+
+#include <atomic>
+
+#include "interned_string.h"
+
+class Counter;
+
+/**
+ * When valueChanged() cascade is slow, profiler shows time spent
+ * in QMetaObject::activate(), but not which connection is to blame.
+ * Tracer records named time spans (slot invocations, bus deliveries,
+ * Signal emissions) and instants (signal emissions of instrumented
+ * objects), so cascade can be inspected offline. Exported file
+ * uses Chrome trace event format, open it with chrome://tracing
+ * or any other local viewer that understands the format.
+ * Bus deliveries and Signal emissions (fast_signal.h) are traced
+ * only when built with QTKOANS_TRACE defined, otherwise there is
+ * no trace code in them at all. Even then tracing is disabled
+ * at runtime by default and costs one atomic load per scope.
+ * When enabled, every thread writes into its own ring buffer
+ * without locks, the oldest records are overwritten when
+ * buffer is full.
+ */
+
+/**
+ * @brief The Tracer class
+ * global switch and export of recorded events.
+ */
+class Tracer
+{
+public:
+    static bool isEnabled();
+    static void setEnabled(bool enabled);
+
+    /**
+     * @brief instant records event without duration.
+     * @param name
+     */
+    static void instant(const InternedString &name);
+
+    /**
+     * @brief clear drops records made so far, can be called
+     * while other threads are tracing.
+     */
+    static void clear();
+    /**
+     * @brief recordCount number of records that would be exported.
+     * @return
+     */
+    static int recordCount();
+    /**
+     * @brief bufferCount number of thread buffers allocated,
+     * buffers of finished threads are reused (needed for test).
+     * @return
+     */
+    static int bufferCount();
+
+    /**
+     * @brief toChromeTrace JSON in Chrome trace event format.
+     * @return
+     */
+    static QByteArray toChromeTrace();
+    static bool writeChromeTrace(const QString &fileName);
+};
+
+/**
+ * @brief The TraceScope class
+ * records time span from construction till destruction.
+ * Name is interned, so keep it in static variable:
+ *     static const InternedString name(QStringLiteral("deliver"));
+ *     TraceScope scope(name);
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const InternedString &name);
+    ~TraceScope();
+
+private:
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+    const InternedString m_name;
+    qint64 m_begin;
+};
+
+/**
+ * @brief traceCounter records instant named after objectName()
+ * every time counter emits valueChanged(). Call it before other
+ * connections are made, so instant precedes slot invocations.
+ * @param counter
+ * @return
+ */
+QMetaObject::Connection traceCounter(Counter* counter);
+/**
+ * @brief traceConnect does the same as connectExample(),
+ * but every invocation of receiver's setValue() is recorded
+ * as span named "sender -> receiver" (by objectName()).
+ * @param sender
+ * @param receiver
+ * @return
+ */
+QMetaObject::Connection traceConnect(Counter* sender, Counter* receiver);
+
+#endif // TRACER_H
@@ -0,0 +1,110 @@
+#include "compactstorage.h"
+
+static bool fitsLatin1(const QString &value)
+{
+    const QChar* data = value.constData();
+    for (int i = 0; i < value.size(); ++i)
+    {
+        if (data[i].unicode() > 0xff)
+            return false;
+    }
+    return true;
+}
+
+CompactStorage::CompactStorage(QStringList data)
+    : m_garbage(0)
+{
+    m_entries.reserve(data.size());
+    for (const QString &value : data)
+        m_entries.append(store(value));
+}
+
+int CompactStorage::size() const
+{
+    return m_entries.size();
+}
+
+QString CompactStorage::at(int i) const
+{
+    const Entry &entry = m_entries.at(i);
+    const char* data = m_arena.constData() + entry.offset;
+    if (entry.utf8)
+        return QString::fromUtf8(data, entry.length);
+    return QString::fromLatin1(data, entry.length);
+}
+
+bool CompactStorage::set(int i, const QString &value)
+{
+    m_garbage += m_entries.at(i).length;
+    m_entries[i] = store(value);
+    if (m_garbage > m_arena.size() / 2)
+        compact();
+    return true;
+}
+
+bool CompactStorage::insert(int position, const QStringList &values)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    if (values.isEmpty())
+        return true;
+    m_entries.insert(position, values.size(), Entry());
+    Entry* entries = m_entries.data() + position;
+    for (int i = 0; i < values.size(); ++i)
+        entries[i] = store(values.at(i));
+    return true;
+}
+
+bool CompactStorage::insert(int position, const QString &value)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    m_entries.insert(position, store(value));
+    return true;
+}
+
+int CompactStorage::arenaSize() const
+{
+    return m_arena.size();
+}
+
+bool CompactStorage::isLatin1(int i) const
+{
+    return !m_entries.at(i).utf8;
+}
+
+CompactStorage::Entry CompactStorage::store(const QString &value)
+{
+    Entry entry;
+    entry.offset = m_arena.size();
+    entry.utf8 = !fitsLatin1(value);
+    if (entry.utf8)
+    {
+        const QByteArray utf8 = value.toUtf8();
+        entry.length = utf8.size();
+        m_arena.append(utf8);
+    }
+    else
+    {
+        // Latin-1 row is appended without temporary byte array
+        entry.length = value.size();
+        m_arena.resize(entry.offset + value.size());
+        char* data = m_arena.data() + entry.offset;
+        const QChar* chars = value.constData();
+        for (int i = 0; i < value.size(); ++i)
+            data[i] = char(chars[i].unicode());
+    }
+    return entry;
+}
+
+void CompactStorage::compact()
+{
+    QByteArray arena;
+    arena.reserve(m_arena.size() - m_garbage);
+    for (Entry &entry : m_entries)
+    {
+        const quint32 offset = arena.size();
+        arena.append(m_arena.constData() + entry.offset, entry.length);
+        entry.offset = offset;
+    }
+    m_arena.swap(arena);
+    m_garbage = 0;
+}
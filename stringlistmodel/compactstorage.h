@@ -0,0 +1,62 @@
+#ifndef COMPACTSTORAGE_H
+#define COMPACTSTORAGE_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "stringliststorage.h"
+
+/**
+ * @brief The CompactStorage class
+ * packs all rows into one byte array (arena), rows are described
+ * by offset and length in it. Row that has only Latin-1 characters
+ * takes one byte per character, other rows are stored in UTF-8.
+ * Compared to QStringList, which costs QString header, separate
+ * heap block and two bytes per character for every row, mostly
+ * ASCII data takes about three times less memory. Price is
+ * conversion to QString in every at().
+ * Arena is append only: set() writes new value to the end and old
+ * bytes become garbage, arena is compacted when garbage takes more
+ * than half of it.
+ */
+class CompactStorage : public StringListStorage
+{
+public:
+    explicit CompactStorage(QStringList data = QStringList());
+
+    int size() const;
+    QString at(int i) const;
+    bool set(int i, const QString &value);
+    bool insert(int position, const QStringList &values);
+    bool insert(int position, const QString &value);
+
+    /**
+     * @brief arenaSize bytes used by row data (needed for test).
+     * @return
+     */
+    int arenaSize() const;
+    /**
+     * @brief isLatin1 if row i is stored in Latin-1 (needed for test).
+     * @param i
+     * @return
+     */
+    bool isLatin1(int i) const;
+
+private:
+    struct Entry
+    {
+        quint32 offset;
+        quint32 length : 31;
+        quint32 utf8 : 1;
+    };
+
+    Entry store(const QString &value);
+    void compact();
+
+    QByteArray m_arena;
+    QVector<Entry> m_entries;
+    // bytes of arena not referenced by any entry
+    int m_garbage;
+};
+
+#endif // COMPACTSTORAGE_H
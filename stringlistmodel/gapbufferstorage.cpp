@@ -0,0 +1,103 @@
+#include "gapbufferstorage.h"
+
+#include <algorithm>
+
+enum { MinimalGap = 16 };
+
+GapBufferStorage::GapBufferStorage(QStringList data)
+    : m_buffer(data.toVector())
+    , m_gapBegin(data.size())
+    , m_gapEnd(data.size())
+{}
+
+int GapBufferStorage::size() const
+{
+    return m_buffer.size() - gapSize();
+}
+
+QString GapBufferStorage::at(int i) const
+{
+    return m_buffer.at(bufferIndex(i));
+}
+
+bool GapBufferStorage::set(int i, const QString &value)
+{
+    m_buffer[bufferIndex(i)] = value;
+    return true;
+}
+
+bool GapBufferStorage::insert(int position, const QStringList &values)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    if (values.isEmpty())
+        return true;
+    moveGap(position);
+    reserveGap(values.size());
+    QString* gap = m_buffer.data() + m_gapBegin;
+    for (int i = 0; i < values.size(); ++i)
+        gap[i] = values.at(i);
+    m_gapBegin += values.size();
+    return true;
+}
+
+bool GapBufferStorage::insert(int position, const QString &value)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    moveGap(position);
+    reserveGap(1);
+    m_buffer[m_gapBegin++] = value;
+    return true;
+}
+
+int GapBufferStorage::gapPosition() const
+{
+    return m_gapBegin;
+}
+
+int GapBufferStorage::gapSize() const
+{
+    return m_gapEnd - m_gapBegin;
+}
+
+int GapBufferStorage::bufferIndex(int i) const
+{
+    Q_ASSERT(i >= 0 && i < size());
+    return i < m_gapBegin ? i : i + gapSize();
+}
+
+void GapBufferStorage::moveGap(int position)
+{
+    // swap instead of move, so the gap keeps only empty strings
+    QString* buffer = m_buffer.data();
+    const int gap = gapSize();
+    while (m_gapBegin > position)
+    {
+        --m_gapBegin;
+        --m_gapEnd;
+        buffer[m_gapBegin].swap(buffer[m_gapEnd]);
+    }
+    while (m_gapBegin < position)
+    {
+        buffer[m_gapBegin].swap(buffer[m_gapEnd]);
+        ++m_gapBegin;
+        ++m_gapEnd;
+    }
+    Q_ASSERT(gapSize() == gap);
+    Q_UNUSED(gap);
+}
+
+void GapBufferStorage::reserveGap(int count)
+{
+    if (gapSize() >= count)
+        return;
+    const int rows = size();
+    // grow geometrically, so inserts are amortized O(1)
+    const int gap = std::max(std::max(count, rows), int(MinimalGap));
+    QVector<QString> buffer(rows + gap);
+    QString* from = m_buffer.data();
+    QString* to = buffer.data();
+    std::move(from, from + m_gapBegin, to);
+    std::move(from + m_gapEnd, from + m_buffer.size(), to + m_gapBegin + gap);
+    m_buffer.swap(buffer);
+    m_gapEnd = m_gapBegin + gap;
+}
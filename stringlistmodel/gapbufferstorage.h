@@ -0,0 +1,45 @@
+#ifndef GAPBUFFERSTORAGE_H
+#define GAPBUFFERSTORAGE_H
+
+#include <QVector>
+
+#include "stringliststorage.h"
+
+/**
+ * @brief The GapBufferStorage class
+ * keeps rows in array with a gap (unused elements) at the place
+ * of last insert, like text editors keep characters near cursor.
+ * Insert next to previous one only fills the gap, so series
+ * of inserts around the same position is amortized O(1) per row.
+ * Insert far away moves the gap there, which costs O(distance).
+ */
+class GapBufferStorage : public StringListStorage
+{
+public:
+    explicit GapBufferStorage(QStringList data = QStringList());
+
+    int size() const;
+    QString at(int i) const;
+    bool set(int i, const QString &value);
+    bool insert(int position, const QStringList &values);
+    bool insert(int position, const QString &value);
+
+    /**
+     * @brief gapPosition index of row after the gap (needed for test).
+     * @return
+     */
+    int gapPosition() const;
+
+private:
+    int gapSize() const;
+    int bufferIndex(int i) const;
+    void moveGap(int position);
+    void reserveGap(int count);
+
+    QVector<QString> m_buffer;
+    // gap is [m_gapBegin, m_gapEnd) of m_buffer
+    int m_gapBegin;
+    int m_gapEnd;
+};
+
+#endif // GAPBUFFERSTORAGE_H
@@ -0,0 +1,148 @@
+#include "internedstorage.h"
+
+#include <QSet>
+#include <QtAlgorithms>
+
+typedef std::lock_guard<std::mutex> guard;
+
+StringPool::Shard::Shard()
+    : count(0)
+{
+    for (std::atomic<QString*> &chunk : chunks)
+        chunk.store(NULL, std::memory_order_relaxed);
+}
+
+StringPool::StringPool()
+{}
+
+StringPool::~StringPool()
+{
+    for (Shard &shard : m_shards)
+    {
+        for (std::atomic<QString*> &chunk : shard.chunks)
+            delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+quint32 StringPool::intern(const QString &value)
+{
+    const quint32 shardIndex = qHash(value) & (Shards - 1);
+    Shard &shard = m_shards[shardIndex];
+    guard g(shard.mutex);
+    auto i = shard.ids.constFind(value);
+    if (i != shard.ids.constEnd())
+        return i.value();
+    const quint32 index = quint32(shard.count);
+    // first string of chunk k has index (FirstChunk << k) - FirstChunk
+    const quint32 chunk = 31 - qCountLeadingZeroBits(index + FirstChunk)
+            - FirstChunkBits;
+    if (shard.chunks[chunk].load(std::memory_order_relaxed) == NULL)
+        shard.chunks[chunk].store(new QString[FirstChunk << chunk],
+                                  std::memory_order_release);
+    *locate(shard, index) = value;
+    ++shard.count;
+    const quint32 id = (index << ShardBits) | shardIndex;
+    shard.ids.insert(value, id);
+    return id;
+}
+
+QString StringPool::value(quint32 id) const
+{
+    // string is written before its id is returned by intern(),
+    // and never changes, so reader doesn't need shard mutex
+    return *locate(m_shards[id & (Shards - 1)], id >> ShardBits);
+}
+
+int StringPool::size() const
+{
+    int size = 0;
+    for (const Shard &shard : m_shards)
+    {
+        guard g(shard.mutex);
+        size += shard.count;
+    }
+    return size;
+}
+
+qint64 StringPool::entryOverhead()
+{
+    return sizeof(QHashNode<QString, quint32>) + sizeof(void*) + sizeof(QString);
+}
+
+QString* StringPool::locate(const Shard &shard, quint32 index)
+{
+    const quint32 position = index + FirstChunk;
+    const quint32 chunk = 31 - qCountLeadingZeroBits(position) - FirstChunkBits;
+    QString* strings = shard.chunks[chunk].load(std::memory_order_acquire);
+    return strings + (position - (quint32(FirstChunk) << chunk));
+}
+
+InternedStorage::InternedStorage(QStringList data, StringPool *pool)
+    : m_ownPool(pool == NULL ? new StringPool() : NULL)
+    , m_pool(pool == NULL ? m_ownPool.data() : pool)
+{
+    m_ids.reserve(data.size());
+    for (const QString &value : data)
+        m_ids.append(m_pool->intern(value));
+}
+
+InternedStorage::~InternedStorage()
+{}
+
+int InternedStorage::size() const
+{
+    return m_ids.size();
+}
+
+QString InternedStorage::at(int i) const
+{
+    return m_pool->value(m_ids.at(i));
+}
+
+bool InternedStorage::set(int i, const QString &value)
+{
+    m_ids[i] = m_pool->intern(value);
+    return true;
+}
+
+bool InternedStorage::insert(int position, const QStringList &values)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    if (values.isEmpty())
+        return true;
+    m_ids.insert(position, values.size(), 0);
+    quint32* ids = m_ids.data() + position;
+    for (int i = 0; i < values.size(); ++i)
+        ids[i] = m_pool->intern(values.at(i));
+    return true;
+}
+
+bool InternedStorage::insert(int position, const QString &value)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    m_ids.insert(position, m_pool->intern(value));
+    return true;
+}
+
+qint64 InternedStorage::memorySaved() const
+{
+    qint64 list = 0;
+    qint64 interned = qint64(m_ids.size()) * sizeof(quint32);
+    QSet<quint32> counted;
+    for (quint32 id : m_ids)
+    {
+        const qint64 cost = listRowCost(m_pool->value(id));
+        list += cost;
+        if (!counted.contains(id))
+        {
+            counted.insert(id);
+            interned += cost + StringPool::entryOverhead();
+        }
+    }
+    return list - interned;
+}
+
+const StringPool *InternedStorage::pool() const
+{
+    return m_pool;
+}
@@ -0,0 +1,127 @@
+#ifndef INTERNEDSTORAGE_H
+#define INTERNEDSTORAGE_H
+
+#include <QHash>
+#include <QScopedPointer>
+#include <QVector>
+
+#include <atomic>
+#include <mutex>
+
+#include "stringliststorage.h"
+
+/**
+ * @brief The StringPool class
+ * keeps every distinct string once and gives it 32 bit id.
+ * Pool is split into shards, each guarded by its own mutex,
+ * so threads interning different strings rarely wait for each
+ * other. Low bits of id select shard. Strings are never removed.
+ * Strings of shard are kept in append-only chunks that never move,
+ * so value() of id returned by intern() reads without lock.
+ */
+class StringPool
+{
+public:
+    enum
+    {
+        ShardBits = 4,
+        Shards = 1 << ShardBits,
+        // chunk k of shard has FirstChunk << k strings
+        FirstChunkBits = 6,
+        FirstChunk = 1 << FirstChunkBits,
+        Chunks = 32 - ShardBits - FirstChunkBits + 1
+    };
+
+    StringPool();
+    ~StringPool();
+
+    /**
+     * @brief intern thread safe.
+     * @param value
+     * @return id, equal strings get equal ids.
+     */
+    quint32 intern(const QString &value);
+    /**
+     * @brief value thread safe, lock free.
+     * @param id returned by intern().
+     * @return
+     */
+    QString value(quint32 id) const;
+    /**
+     * @brief size number of distinct strings.
+     * @return
+     */
+    int size() const;
+    /**
+     * @brief entryOverhead approximate bytes pool spends on every
+     * distinct string besides the string itself: hash node and
+     * bucket, and second QString in chunks (it shares characters
+     * with hash key).
+     * @return
+     */
+    static qint64 entryOverhead();
+
+private:
+    StringPool(const StringPool &) = delete;
+    StringPool &operator=(const StringPool &) = delete;
+
+    struct Shard
+    {
+        Shard();
+
+        mutable std::mutex mutex;
+        QHash<QString, quint32> ids;
+        // guarded by mutex
+        int count;
+        // chunks are published with release, read with acquire
+        std::atomic<QString*> chunks[Chunks];
+    };
+
+    static QString* locate(const Shard &shard, quint32 index);
+
+    Shard m_shards[Shards];
+};
+
+/**
+ * @brief The InternedStorage class
+ * rows are ids of strings in StringPool, so list with heavy
+ * repetition keeps only 4 bytes per row plus every distinct
+ * value once. Pool can be shared by several storages
+ * (and threads filling them).
+ */
+class InternedStorage : public StringListStorage
+{
+public:
+    /**
+     * @brief InternedStorage
+     * @param data
+     * @param pool shared pool, must outlive storage,
+     * if NULL storage creates its own.
+     */
+    explicit InternedStorage(QStringList data = QStringList(),
+                             StringPool *pool = NULL);
+    ~InternedStorage();
+
+    int size() const;
+    QString at(int i) const;
+    bool set(int i, const QString &value);
+    bool insert(int position, const QStringList &values);
+    bool insert(int position, const QString &value);
+
+    /**
+     * @brief memorySaved includes pool's overhead for distinct
+     * values of this storage, so it's negative if values
+     * repeat too rarely to pay for the pool.
+     * @return
+     */
+    qint64 memorySaved() const;
+
+    const StringPool *pool() const;
+
+private:
+    QScopedPointer<StringPool> m_ownPool;
+    StringPool* m_pool;
+    QVector<quint32> m_ids;
+};
+
+#endif // INTERNEDSTORAGE_H
@@ -3,8 +3,19 @@
 #include <QList>
 #include <QMetaObject>
 #include <QMetaMethod>
+#include <QTemporaryFile>
+#include <QSignalSpy>
+#include <QBuffer>
+
+#include <thread>
+#include <vector>
 
 #include "stringlistmodel.h"
+#include "gapbufferstorage.h"
+#include "ropestorage.h"
+#include "mappedfilestorage.h"
+#include "compactstorage.h"
+#include "internedstorage.h"
 
 /**
  * @brief The ListModelFromScratch class
@@ -50,6 +61,19 @@ private slots:
     void rowCount2();
     void direct2();
 
+    // storages, not part of koan
+    void gapBufferStorage();
+    void gapBufferModel();
+    void ropeStorage();
+    void mappedFileStorage_data();
+    void mappedFileStorage();
+    void compactStorage();
+    void internedStorage();
+
+    void fetchMorePages();
+    void producer();
+    void transaction();
+
 public slots:
     void onForbiddenSignal();
     void onDataChanged(const QModelIndex &topLeft,
@@ -517,6 +541,580 @@ void ListModelFromScratch::direct2()
     direct();
 }
 
+/**
+ * @brief storageRows all rows of storage,
+ * to compare them with expected list.
+ */
+static QStringList storageRows(const StringListStorage &storage)
+{
+    QStringList rows;
+    for (int i = 0; i < storage.size(); ++i)
+        rows << storage.at(i);
+    return rows;
+}
+
+void ListModelFromScratch::gapBufferStorage()
+{
+    GapBufferStorage storage(m_data);
+    QStringList expected = m_data;
+    QCOMPARE(storageRows(storage), expected);
+
+    // typing near cursor: gap follows inserts
+    int cursor = 3;
+    for (int i = 0; i < 100; ++i)
+    {
+        QString value = QString::number(i);
+        QVERIFY(storage.insert(cursor, value));
+        expected.insert(cursor, value);
+        ++cursor;
+        QCOMPARE(storage.gapPosition(), cursor);
+    }
+    QCOMPARE(storageRows(storage), expected);
+
+    // jump to another place
+    QStringList list;
+    list << QString::fromLatin1("value1") << QString::fromLatin1("value2");
+    QVERIFY(storage.insert(1, list));
+    expected.insert(1, list[1]);
+    expected.insert(1, list[0]);
+    QVERIFY(storage.insert(storage.size(), list));
+    expected.append(list);
+    QVERIFY(storage.insert(0, QStringList()));
+    QCOMPARE(storageRows(storage), expected);
+
+    QVERIFY(storage.set(2, QString::fromLatin1("new data")));
+    expected[2] = QString::fromLatin1("new data");
+    QCOMPARE(storageRows(storage), expected);
+
+    // model takes ownership of storage
+    StringListModel model(new GapBufferStorage(m_data));
+    QCOMPARE(model.storage()->size(), m_data.size());
+}
+
+/**
+ * @brief ListModelFromScratch::gapBufferModel
+ * model over GapBufferStorage, uses insert() koan,
+ * so it passes once insert() is implemented with m_storage.
+ */
+void ListModelFromScratch::gapBufferModel()
+{
+    StringListModel model(new GapBufferStorage(m_data));
+    QSignalSpy about(&model, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)));
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    const GapBufferStorage *storage
+            = static_cast<const GapBufferStorage*>(model.storage());
+    QStringList expected = m_data;
+
+    // typing near cursor, every insert reports its own row
+    int cursor = 3;
+    for (int i = 0; i < 100; ++i)
+    {
+        QString value = QString::number(i);
+        model.insert(cursor, value);
+        expected.insert(cursor, value);
+        QCOMPARE(about.size(), i + 1);
+        QCOMPARE(inserted.size(), i + 1);
+        QCOMPARE(about.last().at(1).toInt(), cursor);
+        QCOMPARE(about.last().at(2).toInt(), cursor);
+        QCOMPARE(inserted.last().at(1).toInt(), cursor);
+        QCOMPARE(inserted.last().at(2).toInt(), cursor);
+        ++cursor;
+        QCOMPARE(storage->gapPosition(), cursor);
+    }
+    QCOMPARE(model.rowCount(), expected.size());
+
+    // list is one range
+    QStringList list;
+    list << QString::fromLatin1("value1") << QString::fromLatin1("value2")
+         << QString::fromLatin1("value3");
+    model.insert(cursor, list);
+    expected.insert(cursor, list[2]);
+    expected.insert(cursor, list[1]);
+    expected.insert(cursor, list[0]);
+    QCOMPARE(about.size(), 101);
+    QCOMPARE(inserted.size(), 101);
+    QCOMPARE(about.last().at(1).toInt(), cursor);
+    QCOMPARE(about.last().at(2).toInt(), cursor + 2);
+    QCOMPARE(inserted.last().at(1).toInt(), cursor);
+    QCOMPARE(inserted.last().at(2).toInt(), cursor + 2);
+    QCOMPARE(storage->gapPosition(), cursor + 3);
+
+    model.insert(0, QStringList());
+    QCOMPARE(inserted.size(), 101);
+    QCOMPARE(model.rowCount(), expected.size());
+    QCOMPARE(storageRows(*storage), expected);
+}
+
+void ListModelFromScratch::ropeStorage()
+{
+    RopeStorage storage(m_data);
+    QStringList expected = m_data;
+    QCOMPARE(storageRows(storage), expected);
+    QCOMPARE(storage.height(), 1);
+
+    // appends pack leaves, tree stays shallow
+    const int count = RopeStorage::LeafCapacity * RopeStorage::InnerCapacity * 2;
+    for (int i = 0; i < count; ++i)
+    {
+        QString value = QString::number(i);
+        QVERIFY(storage.insert(storage.size(), value));
+        expected.append(value);
+    }
+    QCOMPARE(storage.height(), 3);
+    QCOMPARE(storageRows(storage), expected);
+
+    // prepends and inserts in the middle split nodes
+    for (int i = 0; i < RopeStorage::LeafCapacity * 4; ++i)
+    {
+        QString value = QString::fromLatin1("p") + QString::number(i);
+        QVERIFY(storage.insert(0, value));
+        expected.prepend(value);
+        const int middle = storage.size() / 2;
+        QVERIFY(storage.insert(middle, value));
+        expected.insert(middle, value);
+    }
+    QStringList list;
+    list << QString::fromLatin1("value1") << QString::fromLatin1("value2");
+    QVERIFY(storage.insert(7, list));
+    expected.insert(7, list[1]);
+    expected.insert(7, list[0]);
+    QCOMPARE(storage.size(), expected.size());
+    QCOMPARE(storageRows(storage), expected);
+
+    QVERIFY(storage.set(storage.size() - 1, QString::fromLatin1("new data")));
+    expected.last() = QString::fromLatin1("new data");
+    QCOMPARE(storage.at(storage.size() - 1), expected.last());
+
+    // repeated inserts at leaf boundary keep leaves at least half full
+    RopeStorage boundary;
+    QStringList boundaryExpected;
+    for (int i = 0; i < RopeStorage::LeafCapacity; ++i)
+    {
+        QVERIFY(boundary.insert(boundary.size(), QString::number(i)));
+        boundaryExpected.append(QString::number(i));
+    }
+    for (int i = 0; i < 2000; ++i)
+    {
+        QString value = QString::fromLatin1("x") + QString::number(i);
+        QVERIFY(boundary.insert(RopeStorage::LeafCapacity, value));
+        boundaryExpected.insert(RopeStorage::LeafCapacity, value);
+    }
+    QCOMPARE(storageRows(boundary), boundaryExpected);
+    const int leaves = 2 * boundary.size() / RopeStorage::LeafCapacity + 1;
+    QVERIFY(boundary.nodeCount() <= 2 * leaves);
+    QVERIFY(boundary.height() <= 3);
+
+    // constructor and list inserts make packed leaves
+    QStringList bulk;
+    for (int i = 0; i < RopeStorage::LeafCapacity * 10; ++i)
+        bulk << QString::fromLatin1("b") + QString::number(i);
+    RopeStorage built(bulk);
+    QCOMPARE(storageRows(built), bulk);
+    QCOMPARE(built.height(), 2);
+    QCOMPARE(built.nodeCount(), 11);
+    QStringList builtExpected = bulk;
+    for (int i = 0; i < 20; ++i)
+    {
+        const int middle = built.size() / 2 + 1;
+        QVERIFY(built.insert(middle, bulk));
+        for (int row = bulk.size() - 1; row >= 0; --row)
+            builtExpected.insert(middle, bulk[row]);
+    }
+    QCOMPARE(storageRows(built), builtExpected);
+    const int builtLeaves = 2 * built.size() / RopeStorage::LeafCapacity + 1;
+    QVERIFY(built.nodeCount() <= 2 * builtLeaves);
+    QVERIFY(built.height() <= 3);
+}
+
+void ListModelFromScratch::mappedFileStorage_data()
+{
+    QTest::addColumn<QByteArray>("content");
+    QTest::addColumn<QStringList>("rows");
+
+    QStringList rows;
+    rows << QString::fromLatin1("first") << QString::fromLatin1("second")
+         << QString() << QString::fromUtf8("third \xc3\xa9")
+         << QString::fromLatin1("last");
+    QTest::newRow("empty") << QByteArray() << QStringList();
+    QTest::newRow("newline") << QByteArray("\n") << QStringList(QString());
+    QTest::newRow("no trailing newline")
+            << QByteArray("first\r\nsecond\n\nthird \xc3\xa9\nlast") << rows;
+    QTest::newRow("trailing newline")
+            << QByteArray("first\nsecond\r\n\nthird \xc3\xa9\r\nlast\n") << rows;
+}
+
+void ListModelFromScratch::mappedFileStorage()
+{
+    QFETCH(QByteArray, content);
+    QFETCH(QStringList, rows);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(content), qint64(content.size()));
+    file.close();
+
+    // index built by one and by several threads is the same,
+    // cache smaller than file still returns right rows
+    for (int threads = 1; threads <= 4; ++threads)
+    {
+        MappedFileStorage storage(file.fileName(), 2, threads);
+        QVERIFY(storage.isOpen());
+        QVERIFY(storage.isReadOnly());
+        QCOMPARE(storageRows(storage), rows);
+        QCOMPARE(storageRows(storage), rows);
+        QVERIFY(!storage.insert(0, QString::fromLatin1("value")));
+        QCOMPARE(storage.size(), rows.size());
+    }
+
+    MappedFileStorage missing(file.fileName() + QString::fromLatin1(".missing"));
+    QVERIFY(!missing.isOpen());
+    QCOMPARE(missing.size(), 0);
+}
+
+void ListModelFromScratch::compactStorage()
+{
+    CompactStorage storage(m_data);
+    QStringList expected = m_data;
+    QCOMPARE(storageRows(storage), expected);
+
+    int characters = 0;
+    for (const QString &value : m_data)
+        characters += value.size();
+    // ASCII takes one byte per character
+    QCOMPARE(storage.arenaSize(), characters);
+
+    QStringList list;
+    list << QString::fromUtf8("caf\xc3\xa9")
+         << QString::fromUtf8("\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82")
+         << QString();
+    QVERIFY(storage.insert(2, list));
+    expected.insert(2, list[2]);
+    expected.insert(2, list[1]);
+    expected.insert(2, list[0]);
+    QVERIFY(storage.insert(0, QString::fromLatin1("value")));
+    expected.prepend(QString::fromLatin1("value"));
+    QCOMPARE(storageRows(storage), expected);
+    // Latin-1 is used when possible
+    QVERIFY(storage.isLatin1(0));
+    QVERIFY(storage.isLatin1(3));
+    QVERIFY(!storage.isLatin1(4));
+    QVERIFY(storage.isLatin1(5));
+
+    // garbage left by set() is compacted
+    const int arenaSize = storage.arenaSize();
+    for (int i = 0; i < 1000; ++i)
+    {
+        QVERIFY(storage.set(1, QString::number(i)));
+        expected[1] = QString::number(i);
+    }
+    QVERIFY(storage.arenaSize() <= arenaSize * 2 + 3);
+    QCOMPARE(storageRows(storage), expected);
+}
+
+void ListModelFromScratch::internedStorage()
+{
+    StringPool pool;
+    InternedStorage storage(m_data, &pool);
+    QStringList expected = m_data;
+    QCOMPARE(storageRows(storage), expected);
+    // "an" and "value" are stored once
+    QCOMPARE(pool.size(), m_data.size() - 2);
+    // but two repeats don't pay for pool entries of other values
+    const qint64 saved = storage.memorySaved();
+    QVERIFY(saved < 0);
+
+    QStringList list;
+    for (int i = 0; i < 1000; ++i)
+        list << QString::fromLatin1("value");
+    QVERIFY(storage.insert(3, list));
+    for (int i = 0; i < list.size(); ++i)
+        expected.insert(3, list[i]);
+    QVERIFY(storage.set(0, QString::fromLatin1("an")));
+    expected[0] = QString::fromLatin1("an");
+    QVERIFY(storage.insert(0, QString::fromLatin1("new data")));
+    expected.prepend(QString::fromLatin1("new data"));
+    QCOMPARE(storageRows(storage), expected);
+    QCOMPARE(pool.size(), m_data.size() - 1);
+    QVERIFY(storage.memorySaved() > saved + 1000 * 2 * qint64(sizeof(QChar)));
+    QVERIFY(storage.memorySaved() > 0);
+
+    // pool is shared between threads
+    std::vector<std::thread> threads;
+    std::vector<QVector<quint32>> ids(4);
+    for (int t = 0; t < 4; ++t)
+    {
+        QVector<quint32>* threadIds = &ids[t];
+        threads.push_back(std::thread([&pool, threadIds] () -> void
+        {
+            for (int i = 0; i < 1000; ++i)
+                threadIds->append(pool.intern(QString::number(i)));
+        }));
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+    for (int t = 1; t < 4; ++t)
+        QCOMPARE(ids[t], ids[0]);
+    // values span several chunks of every shard
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(pool.value(ids[0][i]), QString::number(i));
+    QCOMPARE(pool.size(), m_data.size() - 1 + 1000);
+}
+
+/**
+ * @brief checkAppends clears consistent if rows reported by
+ * rowsAboutToBeInserted()/rowsInserted() aren't appended
+ * exactly at rowCount().
+ */
+static void checkAppends(StringListModel &model, bool &consistent)
+{
+    QObject::connect(&model, &QAbstractItemModel::rowsAboutToBeInserted,
+                     [&model, &consistent] (const QModelIndex &, int first, int) -> void
+    {
+        if (model.rowCount() != first)
+            consistent = false;
+    });
+    QObject::connect(&model, &QAbstractItemModel::rowsInserted,
+                     [&model, &consistent] (const QModelIndex &, int, int last) -> void
+    {
+        if (model.rowCount() != last + 1)
+            consistent = false;
+    });
+}
+
+void ListModelFromScratch::fetchMorePages()
+{
+    StringListModel model(new ListStorage());
+    QSignalSpy about(&model, SIGNAL(rowsAboutToBeInserted(QModelIndex,int,int)));
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    bool consistent = true;
+    checkAppends(model, consistent);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+
+    // nothing is generated until view asks
+    int generated = 0;
+    model.setRowSource(new GeneratorRowSource([&generated] (int row) -> QString
+    {
+        ++generated;
+        return QString::number(row);
+    }, 250), 100);
+    QCOMPARE(generated, 0);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    const int pages[][2] = { { 0, 99 }, { 100, 199 }, { 200, 249 } };
+    for (int page = 0; page < 3; ++page)
+    {
+        model.fetchMore(QModelIndex());
+        QCOMPARE(inserted.size(), page + 1);
+        QCOMPARE(about.size(), page + 1);
+        QCOMPARE(inserted.last().at(1).toInt(), pages[page][0]);
+        QCOMPARE(inserted.last().at(2).toInt(), pages[page][1]);
+        QCOMPARE(model.rowCount(), pages[page][1] + 1);
+        QCOMPARE(generated, pages[page][1] + 1);
+    }
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    model.fetchMore(QModelIndex());
+    QCOMPARE(inserted.size(), 3);
+    QCOMPARE(model.rowCount(), 250);
+    QCOMPARE(model.storage()->size(), 250);
+    QCOMPARE(model.storage()->at(249), QString::number(249));
+
+    // lines from device
+    QBuffer buffer;
+    buffer.setData("first\nsecond\r\nthird");
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    model.setRowSource(new DeviceRowSource(&buffer), 2);
+    model.fetchMore(QModelIndex());
+    model.fetchMore(QModelIndex());
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QCOMPARE(inserted.size(), 5);
+    QCOMPARE(inserted.last().at(1).toInt(), 252);
+    QCOMPARE(inserted.last().at(2).toInt(), 252);
+    QCOMPARE(model.rowCount(), 253);
+    QCOMPARE(model.storage()->at(250), QString::fromLatin1("first"));
+    QCOMPARE(model.storage()->at(251), QString::fromLatin1("second"));
+    QCOMPARE(model.storage()->at(252), QString::fromLatin1("third"));
+    QVERIFY(consistent);
+}
+
+void ListModelFromScratch::producer()
+{
+    const int threadCount = 4;
+    const int rowsPerThread = 10000;
+
+    StringListModel model(new ListStorage());
+    QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    bool consistent = true;
+    checkAppends(model, consistent);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        RowProducer producer = model.producer();
+        threads.push_back(std::thread([producer, t, rowsPerThread] () mutable -> void
+        {
+            for (int i = 0; i < rowsPerThread; ++i)
+            {
+                producer.append(QString::number(t) + QLatin1Char(':')
+                                + QString::number(i));
+            }
+        }));
+    }
+    for (std::thread &thread : threads)
+        thread.join();
+
+    // rows wait for event loop, then come in batches
+    QCOMPARE(inserted.size(), 0);
+    QTRY_COMPARE(model.storage()->size(), threadCount * rowsPerThread);
+    QCOMPARE(model.rowCount(), threadCount * rowsPerThread);
+    QVERIFY(inserted.size() < threadCount * rowsPerThread);
+
+    // every batch is appended as one contiguous range
+    int next = 0;
+    for (const QList<QVariant> &arguments : inserted)
+    {
+        QCOMPARE(arguments.at(1).toInt(), next);
+        next = arguments.at(2).toInt() + 1;
+    }
+    QCOMPARE(next, threadCount * rowsPerThread);
+
+    // rows of every producer keep their order
+    QVector<int> expected(threadCount, 0);
+    for (int i = 0; i < model.storage()->size(); ++i)
+    {
+        const QStringList parts = model.storage()->at(i).split(QLatin1Char(':'));
+        const int t = parts.at(0).toInt();
+        QCOMPARE(parts.at(1).toInt(), expected[t]);
+        ++expected[t];
+    }
+
+    // explicit drain doesn't wait for timer
+    RowProducer producer = model.producer();
+    producer.append(QStringList() << QString::fromLatin1("value1")
+                                  << QString::fromLatin1("value2"));
+    model.drainProducers();
+    QCOMPARE(model.storage()->size(), threadCount * rowsPerThread + 2);
+    QCOMPARE(inserted.last().at(1).toInt(), threadCount * rowsPerThread);
+    QCOMPARE(inserted.last().at(2).toInt(), threadCount * rowsPerThread + 1);
+    QCOMPARE(model.rowCount(), threadCount * rowsPerThread + 2);
+    QVERIFY(consistent);
+}
+
+/**
+ * @brief The TransactionModel class
+ * gives test access to notifyDataChanged(),
+ * so transactions can be tested without setData() koan.
+ */
+class TransactionModel : public StringListModel
+{
+public:
+    explicit TransactionModel(ListStorage* rows)
+        : StringListModel(rows)
+        , m_rows(rows)
+    {}
+
+    using StringListModel::notifyDataChanged;
+
+    // insert without koan code, as fetchMore() does
+    void insertRowsDirectly(int position, const QStringList &rows)
+    {
+        beginInsertRows(QModelIndex(), position, position + rows.size() - 1);
+        m_rows->insert(position, rows);
+        endInsertRows();
+    }
+
+private:
+    ListStorage* m_rows;
+};
+
+void ListModelFromScratch::transaction()
+{
+    QStringList rows;
+    rows.reserve(30001);
+    for (int i = 0; i < 30001; ++i)
+        rows.append(QString::number(i));
+    TransactionModel model(new ListStorage(rows));
+    QCOMPARE(model.rowCount(), 30001);
+    QSignalSpy changed(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    const QVector<int> display(1, Qt::DisplayRole);
+
+    // outside of transaction every change is reported
+    model.notifyDataChanged(3, display);
+    model.notifyDataChanged(4, display);
+    QCOMPARE(changed.size(), 2);
+    changed.clear();
+
+    model.beginTransaction();
+    for (int row = 10000; row >= 0; --row)
+        model.notifyDataChanged(row, display);
+    model.notifyDataChanged(5, display);
+    model.beginTransaction();
+    model.notifyDataChanged(20000, QVector<int>(1, Qt::EditRole));
+    model.notifyDataChanged(20002, display);
+    model.notifyDataChanged(20001, display);
+    model.commitTransaction();
+    QVERIFY(model.isInTransaction());
+    QCOMPARE(changed.size(), 0);
+    model.notifyDataChanged(30000, display);
+    model.commitTransaction();
+    QVERIFY(!model.isInTransaction());
+
+    // one signal per contiguous range
+    const int ranges[][2] = { { 0, 10000 }, { 20000, 20002 }, { 30000, 30000 } };
+    QCOMPARE(changed.size(), 3);
+    for (int i = 0; i < 3; ++i)
+    {
+        QCOMPARE(changed.at(i).at(0).value<QModelIndex>().row(), ranges[i][0]);
+        QCOMPARE(changed.at(i).at(1).value<QModelIndex>().row(), ranges[i][1]);
+        QVERIFY(!changed.at(i).at(0).value<QModelIndex>().parent().isValid());
+        const QVector<int> roles = changed.at(i).at(2).value<QVector<int> >();
+        QCOMPARE(roles.size(), 2);
+        QVERIFY(roles.contains(Qt::DisplayRole));
+        QVERIFY(roles.contains(Qt::EditRole));
+    }
+
+    // empty roles mean all roles and win over listed ones
+    changed.clear();
+    model.beginTransaction();
+    model.notifyDataChanged(1, display);
+    model.notifyDataChanged(2, QVector<int>());
+    model.notifyDataChanged(3, QVector<int>(1, Qt::EditRole));
+    model.commitTransaction();
+    QCOMPARE(changed.size(), 1);
+    QCOMPARE(changed.at(0).at(0).value<QModelIndex>().row(), 1);
+    QCOMPARE(changed.at(0).at(1).value<QModelIndex>().row(), 3);
+    QVERIFY(changed.at(0).at(2).value<QVector<int> >().isEmpty());
+
+    // next transaction starts with no roles again
+    model.beginTransaction();
+    model.notifyDataChanged(7, display);
+    model.commitTransaction();
+    QCOMPARE(changed.size(), 2);
+    QCOMPARE(changed.at(1).at(2).value<QVector<int> >(), display);
+
+    // empty transaction emits nothing
+    model.beginTransaction();
+    model.commitTransaction();
+    QCOMPARE(changed.size(), 2);
+
+    // rows inserted in transaction move remembered rows below them
+    changed.clear();
+    model.beginTransaction();
+    model.notifyDataChanged(10, display);
+    model.notifyDataChanged(11, display);
+    model.notifyDataChanged(40, display);
+    model.insertRowsDirectly(11, QStringList() << QString::fromLatin1("a")
+                             << QString::fromLatin1("b"));
+    model.commitTransaction();
+    QCOMPARE(model.rowCount(), 30003);
+    const int moved[] = { 10, 13, 42 };
+    QCOMPARE(changed.size(), 3);
+    for (int i = 0; i < 3; ++i)
+    {
+        QCOMPARE(changed.at(i).at(0).value<QModelIndex>().row(), moved[i]);
+        QCOMPARE(changed.at(i).at(1).value<QModelIndex>().row(), moved[i]);
+    }
+}
+
 void ListModelFromScratch::onForbiddenSignal()
 {
     m_error = true;
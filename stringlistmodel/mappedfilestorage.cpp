@@ -0,0 +1,149 @@
+#include "mappedfilestorage.h"
+
+#include <QThread>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief findLineStarts collects positions after every '\n'
+ * in [from, to) of data.
+ */
+static void findLineStarts(const uchar* data, qint64 from, qint64 to,
+                           QVector<qint64>* starts)
+{
+    const uchar* position = data + from;
+    const uchar* end = data + to;
+    while (position < end)
+    {
+        const void* found = std::memchr(position, '\n', end - position);
+        if (found == NULL)
+            break;
+        position = static_cast<const uchar*>(found) + 1;
+        starts->append(position - data);
+    }
+}
+
+MappedFileStorage::MappedFileStorage(const QString &fileName, int cacheSize,
+                                     int threads)
+    : m_file(fileName)
+    , m_data(NULL)
+    , m_size(0)
+    , m_open(false)
+    , m_cache(cacheSize)
+{
+    if (!m_file.open(QIODevice::ReadOnly))
+        return;
+    m_size = m_file.size();
+    if (m_size > 0)
+    {
+        m_data = m_file.map(0, m_size);
+        if (m_data == NULL)
+        {
+            m_size = 0;
+            return;
+        }
+    }
+    m_open = true;
+    buildIndex(threads);
+}
+
+bool MappedFileStorage::isOpen() const
+{
+    return m_open;
+}
+
+int MappedFileStorage::size() const
+{
+    return m_lineStarts.isEmpty() ? 0 : m_lineStarts.size() - 1;
+}
+
+QString MappedFileStorage::at(int i) const
+{
+    Q_ASSERT(i >= 0 && i < size());
+    if (const QString* cached = m_cache.object(i))
+        return *cached;
+    const qint64 start = m_lineStarts.at(i);
+    // next row starts after '\n', last row may have none
+    qint64 end = std::min(m_lineStarts.at(i + 1) - 1, m_size);
+    if (end > start && m_data[end - 1] == '\r')
+        --end;
+    const QString row = QString::fromUtf8(
+                reinterpret_cast<const char*>(m_data + start), int(end - start));
+    m_cache.insert(i, new QString(row));
+    return row;
+}
+
+bool MappedFileStorage::isReadOnly() const
+{
+    return true;
+}
+
+bool MappedFileStorage::set(int i, const QString &value)
+{
+    Q_UNUSED(i);
+    Q_UNUSED(value);
+    return false;
+}
+
+bool MappedFileStorage::insert(int position, const QStringList &values)
+{
+    Q_UNUSED(position);
+    Q_UNUSED(values);
+    return false;
+}
+
+bool MappedFileStorage::insert(int position, const QString &value)
+{
+    Q_UNUSED(position);
+    Q_UNUSED(value);
+    return false;
+}
+
+void MappedFileStorage::buildIndex(int threads)
+{
+    m_lineStarts.clear();
+    m_lineStarts.append(0);
+    if (m_size == 0)
+        return;
+
+    qint64 chunks = threads;
+    if (threads <= 0)
+    {
+        chunks = std::min<qint64>(QThread::idealThreadCount(),
+                                  m_size / MinimalChunk);
+    }
+    chunks = std::max<qint64>(1, std::min(chunks, m_size));
+
+    // every thread scans its own part of file, results are
+    // concatenated in order of parts
+    std::vector<QVector<qint64>> parts(chunks);
+    std::vector<std::thread> workers;
+    const qint64 chunkSize = m_size / chunks;
+    for (qint64 i = 0; i < chunks; ++i)
+    {
+        const qint64 from = i * chunkSize;
+        const qint64 to = i == chunks - 1 ? m_size : from + chunkSize;
+        QVector<qint64>* part = &parts[i];
+        if (i == chunks - 1)
+            findLineStarts(m_data, from, to, part);
+        else
+            workers.push_back(std::thread(findLineStarts, m_data, from, to, part));
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+
+    int total = 1;
+    for (const QVector<qint64> &part : parts)
+        total += part.size();
+    m_lineStarts.reserve(total + 1);
+    for (const QVector<qint64> &part : parts)
+        m_lineStarts += part;
+
+    // file that doesn't end with '\n' has one more row,
+    // which ends at the end of file
+    if (m_lineStarts.last() != m_size)
+        m_lineStarts.append(m_size + 1);
+}
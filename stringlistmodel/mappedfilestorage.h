@@ -0,0 +1,60 @@
+#ifndef MAPPEDFILESTORAGE_H
+#define MAPPEDFILESTORAGE_H
+
+#include <QCache>
+#include <QFile>
+#include <QVector>
+
+#include "stringliststorage.h"
+
+/**
+ * @brief The MappedFileStorage class
+ * read only storage over UTF-8 text file, one row per line
+ * ("\n" or "\r\n" separated). File is memory mapped, not read,
+ * so opening multi-gigabyte file costs only building index of line
+ * starts, which is done by several threads in parallel.
+ * Rows are decoded to QString only when requested by at(),
+ * recently decoded rows are kept in small LRU cache.
+ */
+class MappedFileStorage : public StringListStorage
+{
+public:
+    /**
+     * @brief MappedFileStorage
+     * @param fileName
+     * @param cacheSize number of decoded rows kept in cache.
+     * @param threads to build index with, 0 - QThread::idealThreadCount(),
+     * but not more than one thread per MinimalChunk bytes.
+     */
+    explicit MappedFileStorage(const QString &fileName, int cacheSize = 1024,
+                               int threads = 0);
+
+    enum { MinimalChunk = 1024 * 1024 };
+
+    /**
+     * @brief isOpen false if file could not be opened or mapped,
+     * storage is empty then.
+     * @return
+     */
+    bool isOpen() const;
+
+    int size() const;
+    QString at(int i) const;
+    bool isReadOnly() const;
+    bool set(int i, const QString &value);
+    bool insert(int position, const QStringList &values);
+    bool insert(int position, const QString &value);
+
+private:
+    void buildIndex(int threads);
+
+    QFile m_file;
+    const uchar* m_data;
+    qint64 m_size;
+    bool m_open;
+    // start of every row plus start of the row after last one
+    QVector<qint64> m_lineStarts;
+    mutable QCache<int, QString> m_cache;
+};
+
+#endif // MAPPEDFILESTORAGE_H
@@ -0,0 +1,390 @@
+#include "ropestorage.h"
+
+#include <QVector>
+
+struct RopeStorage::Node
+{
+    explicit Node(bool leaf)
+        : leaf(leaf)
+        , count(0)
+        , size(0)
+    {}
+
+    const bool leaf;
+    // rows in leaf, children in inner node
+    int count;
+    // rows in subtree
+    int size;
+};
+
+struct RopeStorage::Leaf : public RopeStorage::Node
+{
+    Leaf()
+        : Node(true)
+    {}
+
+    QString rows[LeafCapacity];
+};
+
+struct RopeStorage::Inner : public RopeStorage::Node
+{
+    Inner()
+        : Node(false)
+    {}
+
+    Node* children[InnerCapacity];
+};
+
+RopeStorage::RopeStorage(QStringList data)
+    : m_root(NULL)
+    , m_height(1)
+{
+    m_root = build(data, m_height);
+}
+
+RopeStorage::~RopeStorage()
+{
+    destroy(m_root);
+}
+
+int RopeStorage::size() const
+{
+    return m_root->size;
+}
+
+QString RopeStorage::at(int i) const
+{
+    Q_ASSERT(i >= 0 && i < size());
+    return *find(m_root, i);
+}
+
+bool RopeStorage::set(int i, const QString &value)
+{
+    Q_ASSERT(i >= 0 && i < size());
+    *find(m_root, i) = value;
+    return true;
+}
+
+bool RopeStorage::insert(int position, const QStringList &values)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    if (values.size() < LeafCapacity)
+    {
+        for (int i = 0; i < values.size(); ++i)
+            insert(position + i, values.at(i));
+        return true;
+    }
+    if (size() == 0)
+    {
+        destroy(m_root);
+        m_root = build(values, m_height);
+        return true;
+    }
+
+    // rows after position in its leaf go after new rows,
+    // so new leaves are linked between existing ones
+    QStringList rows = values;
+    if (position > 0)
+        cutLeaf(m_root, position, rows);
+    if (m_root->leaf)
+    {
+        Inner* root = new Inner();
+        root->children[0] = m_root;
+        root->count = 1;
+        root->size = m_root->size;
+        m_root = root;
+        ++m_height;
+    }
+
+    // leaves are filled evenly, so each is at least half full
+    const int leaves = (rows.size() + LeafCapacity - 1) / LeafCapacity;
+    int first = 0;
+    for (int i = 0; i < leaves; ++i)
+    {
+        const int last = int(qint64(rows.size()) * (i + 1) / leaves);
+        Leaf* leaf = new Leaf();
+        for (int row = first; row < last; ++row)
+            leaf->rows[row - first] = rows.at(row);
+        leaf->count = last - first;
+        leaf->size = leaf->count;
+        const bool append = position == size();
+        growRoot(insertLeaf(static_cast<Inner*>(m_root), position, leaf, append));
+        position += leaf->size;
+        first = last;
+    }
+    return true;
+}
+
+bool RopeStorage::insert(int position, const QString &value)
+{
+    Q_ASSERT(position >= 0 && position <= size());
+    growRoot(insert(m_root, position, value, position == size()));
+    return true;
+}
+
+void RopeStorage::growRoot(Node* sibling)
+{
+    if (sibling == NULL)
+        return;
+    // root was split, tree grows by one level
+    Inner* root = new Inner();
+    root->children[0] = m_root;
+    root->children[1] = sibling;
+    root->count = 2;
+    root->size = m_root->size + sibling->size;
+    m_root = root;
+    ++m_height;
+}
+
+int RopeStorage::height() const
+{
+    return m_height;
+}
+
+int RopeStorage::nodeCount() const
+{
+    return countNodes(m_root);
+}
+
+void RopeStorage::destroy(Node* node)
+{
+    if (node->leaf)
+    {
+        delete static_cast<Leaf*>(node);
+        return;
+    }
+    Inner* inner = static_cast<Inner*>(node);
+    for (int i = 0; i < inner->count; ++i)
+        destroy(inner->children[i]);
+    delete inner;
+}
+
+QString* RopeStorage::find(Node* node, int &i)
+{
+    while (!node->leaf)
+    {
+        Inner* inner = static_cast<Inner*>(node);
+        int child = 0;
+        while (i >= inner->children[child]->size)
+        {
+            i -= inner->children[child]->size;
+            ++child;
+        }
+        node = inner->children[child];
+    }
+    return &static_cast<Leaf*>(node)->rows[i];
+}
+
+RopeStorage::Node* RopeStorage::insert(Node* node, int position,
+                                       const QString &value, bool append)
+{
+    if (node->leaf)
+        return insertIntoLeaf(static_cast<Leaf*>(node), position, value, append);
+    return insertIntoInner(static_cast<Inner*>(node), position, value, append);
+}
+
+/**
+ * Both insert functions return new right sibling if node was split
+ * and NULL otherwise. Leaf is split when value doesn't fit into it,
+ * inner node when new child doesn't. When appending to the end
+ * of the whole list (append is true only on the rightmost path),
+ * all old content stays in place and sibling gets only the new one,
+ * so appended rows pack nodes completely. Otherwise node is split
+ * in halves, as repeated inserts at the same place would leave
+ * a trail of almost empty nodes.
+ */
+RopeStorage::Node* RopeStorage::insertIntoLeaf(Leaf* leaf, int position,
+                                               const QString &value, bool append)
+{
+    Leaf* sibling = NULL;
+    if (leaf->count == LeafCapacity)
+    {
+        sibling = new Leaf();
+        const int keep = append ? LeafCapacity : LeafCapacity / 2;
+        for (int i = keep; i < LeafCapacity; ++i)
+            sibling->rows[i - keep].swap(leaf->rows[i]);
+        sibling->count = LeafCapacity - keep;
+        sibling->size = sibling->count;
+        leaf->count = keep;
+        leaf->size = keep;
+        if (position >= keep)
+        {
+            position -= keep;
+            leaf = sibling;
+        }
+    }
+    for (int i = leaf->count; i > position; --i)
+        leaf->rows[i].swap(leaf->rows[i - 1]);
+    leaf->rows[position] = value;
+    ++leaf->count;
+    ++leaf->size;
+    return sibling;
+}
+
+RopeStorage::Node* RopeStorage::insertIntoInner(Inner* inner, int position,
+                                                const QString &value, bool append)
+{
+    int child = 0;
+    while (child < inner->count - 1 && position > inner->children[child]->size)
+    {
+        position -= inner->children[child]->size;
+        ++child;
+    }
+    Node* split = insert(inner->children[child], position, value, append);
+    ++inner->size;
+    if (split == NULL)
+        return NULL;
+    return addChild(inner, child + 1, split, append);
+}
+
+/**
+ * Inserts child at index, inner->size must already include it.
+ * Returns new right sibling if inner was split, NULL otherwise.
+ */
+RopeStorage::Inner* RopeStorage::addChild(Inner* inner, int index, Node* child,
+                                          bool append)
+{
+    Inner* target = inner;
+    Inner* sibling = NULL;
+    if (inner->count == InnerCapacity)
+    {
+        sibling = new Inner();
+        const int keep = append ? InnerCapacity : InnerCapacity / 2;
+        for (int i = keep; i < InnerCapacity; ++i)
+            sibling->children[i - keep] = inner->children[i];
+        sibling->count = InnerCapacity - keep;
+        inner->count = keep;
+        if (index >= keep)
+        {
+            target = sibling;
+            index -= keep;
+        }
+    }
+    for (int i = target->count; i > index; --i)
+        target->children[i] = target->children[i - 1];
+    target->children[index] = child;
+    ++target->count;
+    if (sibling != NULL)
+    {
+        sibling->size = subtreeSize(sibling);
+        inner->size = subtreeSize(inner);
+    }
+    return sibling;
+}
+
+/**
+ * Links leaf into the tree so that its first row gets index position,
+ * position must be at boundary between leaves (see cutLeaf()).
+ */
+RopeStorage::Node* RopeStorage::insertLeaf(Inner* inner, int position,
+                                           Leaf* leaf, bool append)
+{
+    int child = 0;
+    while (child < inner->count - 1 && position > inner->children[child]->size)
+    {
+        position -= inner->children[child]->size;
+        ++child;
+    }
+    inner->size += leaf->size;
+    if (inner->children[child]->leaf)
+    {
+        Q_ASSERT(position == 0 || position == inner->children[child]->size);
+        return addChild(inner, position == 0 ? child : child + 1, leaf, append);
+    }
+    Node* split = insertLeaf(static_cast<Inner*>(inner->children[child]),
+                             position, leaf, append);
+    if (split == NULL)
+        return NULL;
+    return addChild(inner, child + 1, split, append);
+}
+
+/**
+ * Moves rows from position to the end of leaf that has
+ * row position - 1 to tail, so position becomes boundary
+ * between leaves. Returns number of moved rows.
+ */
+int RopeStorage::cutLeaf(Node* node, int position, QStringList &tail)
+{
+    if (node->leaf)
+    {
+        Leaf* leaf = static_cast<Leaf*>(node);
+        const int cut = leaf->count - position;
+        for (int i = position; i < leaf->count; ++i)
+        {
+            tail.append(leaf->rows[i]);
+            leaf->rows[i] = QString();
+        }
+        leaf->count = position;
+        leaf->size = position;
+        return cut;
+    }
+    Inner* inner = static_cast<Inner*>(node);
+    int child = 0;
+    while (child < inner->count - 1 && position > inner->children[child]->size)
+    {
+        position -= inner->children[child]->size;
+        ++child;
+    }
+    const int cut = cutLeaf(inner->children[child], position, tail);
+    inner->size -= cut;
+    return cut;
+}
+
+/**
+ * Builds tree bottom up: full leaves, then full inner nodes
+ * level by level, so only the last node of each level isn't full.
+ */
+RopeStorage::Node* RopeStorage::build(const QStringList &rows, int &height)
+{
+    QVector<Node*> level;
+    for (int first = 0; first < rows.size(); first += LeafCapacity)
+    {
+        Leaf* leaf = new Leaf();
+        leaf->count = qMin(int(LeafCapacity), rows.size() - first);
+        leaf->size = leaf->count;
+        for (int i = 0; i < leaf->count; ++i)
+            leaf->rows[i] = rows.at(first + i);
+        level.append(leaf);
+    }
+    if (level.isEmpty())
+        level.append(new Leaf());
+
+    height = 1;
+    while (level.size() > 1)
+    {
+        QVector<Node*> parents;
+        for (int first = 0; first < level.size(); first += InnerCapacity)
+        {
+            Inner* inner = new Inner();
+            inner->count = qMin(int(InnerCapacity), level.size() - first);
+            for (int i = 0; i < inner->count; ++i)
+            {
+                inner->children[i] = level.at(first + i);
+                inner->size += inner->children[i]->size;
+            }
+            parents.append(inner);
+        }
+        level.swap(parents);
+        ++height;
+    }
+    return level.first();
+}
+
+int RopeStorage::countNodes(const Node* node)
+{
+    if (node->leaf)
+        return 1;
+    const Inner* inner = static_cast<const Inner*>(node);
+    int count = 1;
+    for (int i = 0; i < inner->count; ++i)
+        count += countNodes(inner->children[i]);
+    return count;
+}
+
+int RopeStorage::subtreeSize(const Inner* inner)
+{
+    int size = 0;
+    for (int i = 0; i < inner->count; ++i)
+        size += inner->children[i]->size;
+    return size;
+}
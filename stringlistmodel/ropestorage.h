@@ -0,0 +1,81 @@
+#ifndef ROPESTORAGE_H
+#define ROPESTORAGE_H
+
+#include "stringliststorage.h"
+
+/**
+ * @brief The RopeStorage class
+ * keeps rows in leaves (chunks of up to LeafCapacity rows)
+ * of counted B-tree: every inner node knows how many rows
+ * are under each of its children. Finding row by index,
+ * inserting and prepending is O(log n), and instead of one huge
+ * array tree allocates nodes of fixed size, so no large
+ * reallocation happens when list grows to tens of millions of rows.
+ * Appending to the end of the whole list fills leaves completely,
+ * any other insert splits full node in halves, so every node
+ * except the last ones is at least half full.
+ * Constructor builds packed tree bottom up in O(n), insert of a list
+ * of at least LeafCapacity rows builds new leaves from it and links
+ * them into the tree, so it costs O(k + k / LeafCapacity * log n)
+ * instead of O(k log n) for k rows.
+ */
+class RopeStorage : public StringListStorage
+{
+public:
+    enum
+    {
+        LeafCapacity = 64,
+        InnerCapacity = 32
+    };
+
+    explicit RopeStorage(QStringList data = QStringList());
+    ~RopeStorage();
+
+    int size() const;
+    QString at(int i) const;
+    bool set(int i, const QString &value);
+    bool insert(int position, const QStringList &values);
+    bool insert(int position, const QString &value);
+
+    /**
+     * @brief height number of levels, 1 for single leaf
+     * (needed for test).
+     * @return
+     */
+    int height() const;
+    /**
+     * @brief nodeCount number of allocated nodes (needed for test).
+     * @return
+     */
+    int nodeCount() const;
+
+private:
+    RopeStorage(const RopeStorage &) = delete;
+    RopeStorage &operator=(const RopeStorage &) = delete;
+
+    struct Node;
+    struct Leaf;
+    struct Inner;
+
+    static void destroy(Node* node);
+    static QString* find(Node* node, int &i);
+    static Node* insert(Node* node, int position, const QString &value,
+                        bool append);
+    static Node* insertIntoLeaf(Leaf* leaf, int position, const QString &value,
+                                bool append);
+    static Node* insertIntoInner(Inner* inner, int position,
+                                 const QString &value, bool append);
+    static Inner* addChild(Inner* inner, int index, Node* child, bool append);
+    static Node* insertLeaf(Inner* inner, int position, Leaf* leaf,
+                            bool append);
+    static int cutLeaf(Node* node, int position, QStringList &tail);
+    static Node* build(const QStringList &rows, int &height);
+    void growRoot(Node* sibling);
+    static int countNodes(const Node* node);
+    static int subtreeSize(const Inner* inner);
+
+    Node* m_root;
+    int m_height;
+};
+
+#endif // ROPESTORAGE_H
@@ -0,0 +1,121 @@
+#include "rowproducer.h"
+
+#include <QMetaObject>
+#include <QObject>
+
+typedef std::lock_guard<std::mutex> guard;
+
+RowQueue::RowQueue()
+    : m_head(NULL)
+    , m_context(NULL)
+{}
+
+RowQueue::~RowQueue()
+{
+    Node* node = m_head.load();
+    while (node != NULL)
+    {
+        Node* next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+void RowQueue::setReceiver(QObject* context, std::function<void()> wake)
+{
+    guard g(m_receiverMutex);
+    m_context = context;
+    m_wake = wake;
+}
+
+void RowQueue::push(const QString &value)
+{
+    Node* node = new Node;
+    node->value = value;
+    node->next = NULL;
+    push(node, node);
+}
+
+void RowQueue::push(const QStringList &values)
+{
+    if (values.isEmpty())
+        return;
+    // list is kept newest first, link values in reverse
+    Node* first = NULL;
+    Node* last = NULL;
+    for (const QString &value : values)
+    {
+        Node* node = new Node;
+        node->value = value;
+        node->next = first;
+        first = node;
+        if (last == NULL)
+            last = node;
+    }
+    push(first, last);
+}
+
+QStringList RowQueue::takeAll()
+{
+    Node* node = m_head.exchange(NULL, std::memory_order_acquire);
+    int count = 0;
+    for (Node* i = node; i != NULL; i = i->next)
+        ++count;
+    QStringList values;
+    values.reserve(count);
+    for (int i = 0; i < count; ++i)
+        values.append(QString());
+    // newest first -> fill from the end
+    for (int i = count - 1; i >= 0; --i)
+    {
+        Node* next = node->next;
+        values[i].swap(node->value);
+        delete node;
+        node = next;
+    }
+    return values;
+}
+
+void RowQueue::push(Node* first, Node* last)
+{
+    Node* head = m_head.load(std::memory_order_relaxed);
+    do
+    {
+        last->next = head;
+    }
+    while (!m_head.compare_exchange_weak(head, first,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed));
+    if (head == NULL)
+        wake();
+}
+
+void RowQueue::wake()
+{
+    guard g(m_receiverMutex);
+    if (m_context == NULL)
+        return;
+    QMetaObject::invokeMethod(m_context, m_wake, Qt::QueuedConnection);
+}
+
+RowProducer::RowProducer()
+{}
+
+RowProducer::RowProducer(std::shared_ptr<RowQueue> queue)
+    : m_queue(queue)
+{}
+
+bool RowProducer::isNull() const
+{
+    return !m_queue;
+}
+
+void RowProducer::append(const QString &value)
+{
+    m_queue->push(value);
+}
+
+void RowProducer::append(const QStringList &values)
+{
+    m_queue->push(values);
+}
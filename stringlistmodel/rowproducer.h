@@ -0,0 +1,86 @@
+#ifndef ROWPRODUCER_H
+#define ROWPRODUCER_H
+
+#include <QStringList>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+class QObject;
+
+/**
+ * @brief The RowQueue class
+ * lock-free list of rows pushed by any number of threads
+ * and taken all at once by one consumer. Push is compare and swap
+ * of list head, take is exchange of head with NULL.
+ * When push makes list non-empty, wake function is posted
+ * to context object's thread, so consumer learns about new rows
+ * once per batch instead of once per row.
+ */
+class RowQueue
+{
+public:
+    RowQueue();
+    ~RowQueue();
+
+    /**
+     * @brief setReceiver context and wake function,
+     * NULL context stops waking. Thread safe.
+     * @param context
+     * @param wake
+     */
+    void setReceiver(QObject* context, std::function<void()> wake);
+
+    void push(const QString &value);
+    void push(const QStringList &values);
+    /**
+     * @brief takeAll rows in order they were pushed
+     * (only one thread may take).
+     * @return
+     */
+    QStringList takeAll();
+
+private:
+    RowQueue(const RowQueue &) = delete;
+    RowQueue &operator=(const RowQueue &) = delete;
+
+    struct Node
+    {
+        QString value;
+        Node* next;
+    };
+
+    void push(Node* first, Node* last);
+    void wake();
+
+    std::atomic<Node*> m_head;
+    // guards receiver only, taken once per batch, not per row
+    std::mutex m_receiverMutex;
+    QObject* m_context;
+    std::function<void()> m_wake;
+};
+
+/**
+ * @brief The RowProducer class
+ * handle to append rows to StringListModel from any thread
+ * (see StringListModel::producer()). Cheap to copy, can outlive
+ * model, rows appended after model is destroyed are dropped.
+ */
+class RowProducer
+{
+public:
+    RowProducer();
+    explicit RowProducer(std::shared_ptr<RowQueue> queue);
+
+    bool isNull() const;
+
+    void append(const QString &value);
+    void append(const QStringList &values);
+
+private:
+    std::shared_ptr<RowQueue> m_queue;
+};
+
+#endif // ROWPRODUCER_H
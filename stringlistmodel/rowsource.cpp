@@ -0,0 +1,53 @@
+#include "rowsource.h"
+
+#include <QIODevice>
+
+RowSource::~RowSource()
+{}
+
+GeneratorRowSource::GeneratorRowSource(Generator generator, int count)
+    : m_generator(generator)
+    , m_count(count)
+    , m_next(0)
+{}
+
+bool GeneratorRowSource::atEnd() const
+{
+    return m_next >= m_count;
+}
+
+QStringList GeneratorRowSource::fetch(int count)
+{
+    QStringList rows;
+    const int last = qMin(m_count, m_next + count);
+    rows.reserve(last - m_next);
+    for (; m_next < last; ++m_next)
+        rows.append(m_generator(m_next));
+    return rows;
+}
+
+DeviceRowSource::DeviceRowSource(QIODevice* device)
+    : m_device(device)
+{}
+
+bool DeviceRowSource::atEnd() const
+{
+    if (m_device->isSequential())
+        return !m_device->canReadLine();
+    return m_device->atEnd();
+}
+
+QStringList DeviceRowSource::fetch(int count)
+{
+    QStringList rows;
+    while (rows.size() < count && !atEnd())
+    {
+        QByteArray line = m_device->readLine();
+        if (line.endsWith('\n'))
+            line.chop(1);
+        if (line.endsWith('\r'))
+            line.chop(1);
+        rows.append(QString::fromUtf8(line));
+    }
+    return rows;
+}
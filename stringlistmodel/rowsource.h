@@ -0,0 +1,73 @@
+#ifndef ROWSOURCE_H
+#define ROWSOURCE_H
+
+#include <QStringList>
+
+#include <functional>
+
+class QIODevice;
+
+/**
+ * @brief The RowSource class
+ * gives rows to StringListModel page by page,
+ * when view asks for more (see QAbstractItemModel::fetchMore()),
+ * so model doesn't need all rows up front.
+ */
+class RowSource
+{
+public:
+    virtual ~RowSource();
+
+    /**
+     * @brief atEnd true if there are no rows to fetch now.
+     * @return
+     */
+    virtual bool atEnd() const = 0;
+    /**
+     * @brief fetch next rows.
+     * @param count
+     * @return no more than count rows.
+     */
+    virtual QStringList fetch(int count) = 0;
+};
+
+/**
+ * @brief The GeneratorRowSource class
+ * produces count rows by calling generator(row).
+ */
+class GeneratorRowSource : public RowSource
+{
+public:
+    typedef std::function<QString(int)> Generator;
+
+    GeneratorRowSource(Generator generator, int count);
+
+    bool atEnd() const;
+    QStringList fetch(int count);
+
+private:
+    Generator m_generator;
+    int m_count;
+    int m_next;
+};
+
+/**
+ * @brief The DeviceRowSource class
+ * reads UTF-8 lines from device (file, socket, process).
+ * From sequential device (socket) only complete lines are read,
+ * so source is at end while next line hasn't arrived yet, and
+ * can fetch again later. Device is not owned and must be open.
+ */
+class DeviceRowSource : public RowSource
+{
+public:
+    explicit DeviceRowSource(QIODevice* device);
+
+    bool atEnd() const;
+    QStringList fetch(int count);
+
+private:
+    QIODevice* m_device;
+};
+
+#endif // ROWSOURCE_H
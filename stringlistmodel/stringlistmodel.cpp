@@ -1,14 +1,171 @@
 #include "stringlistmodel.h"
 
+#include <algorithm>
+
 StringListModel::StringListModel(QStringList data, QObject *parent)
     : QAbstractItemModel(parent)
+    , m_storage(new ListStorage(data))
+    , m_pageSize(0)
+    , m_transactionDepth(0)
+    , m_allRolesChanged(false)
 {
+    connect(this, &StringListModel::rowsInserted,
+            this, &StringListModel::shiftChangedRows);
+}
 
+StringListModel::StringListModel(StringListStorage *storage, QObject *parent)
+    : QAbstractItemModel(parent)
+    , m_storage(storage)
+    , m_pageSize(0)
+    , m_transactionDepth(0)
+    , m_allRolesChanged(false)
+{
+    connect(this, &StringListModel::rowsInserted,
+            this, &StringListModel::shiftChangedRows);
 }
 
 StringListModel::~StringListModel()
 {
+    // producers can outlive model
+    if (m_queue)
+        m_queue->setReceiver(NULL, std::function<void()>());
+}
+
+const StringListStorage *StringListModel::storage() const
+{
+    return m_storage.data();
+}
 
+void StringListModel::setRowSource(RowSource *source, int pageSize)
+{
+    Q_ASSERT(pageSize > 0);
+    m_source.reset(source);
+    m_pageSize = pageSize;
+}
+
+bool StringListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !m_source.isNull() && !m_source->atEnd()
+            && !m_storage->isReadOnly();
+}
+
+void StringListModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+    const QStringList rows = m_source->fetch(m_pageSize);
+    if (rows.isEmpty())
+        return;
+    const int first = m_storage->size();
+    beginInsertRows(QModelIndex(), first, first + rows.size() - 1);
+    m_storage->insert(first, rows);
+    endInsertRows();
+}
+
+RowProducer StringListModel::producer()
+{
+    if (!m_queue)
+    {
+        m_queue = std::make_shared<RowQueue>();
+        m_drainTimer.setSingleShot(true);
+        m_drainTimer.setInterval(DrainInterval);
+        connect(&m_drainTimer, &QTimer::timeout, this, [this] () -> void
+        {
+            drainProducers();
+        });
+        m_queue->setReceiver(this, [this] () -> void
+        {
+            if (!m_drainTimer.isActive())
+                m_drainTimer.start();
+        });
+    }
+    return RowProducer(m_queue);
+}
+
+void StringListModel::drainProducers()
+{
+    if (!m_queue)
+        return;
+    m_drainTimer.stop();
+    const QStringList rows = m_queue->takeAll();
+    if (rows.isEmpty())
+        return;
+    const int first = m_storage->size();
+    beginInsertRows(QModelIndex(), first, first + rows.size() - 1);
+    m_storage->insert(first, rows);
+    endInsertRows();
+}
+
+void StringListModel::beginTransaction()
+{
+    ++m_transactionDepth;
+}
+
+void StringListModel::commitTransaction()
+{
+    Q_ASSERT(m_transactionDepth > 0);
+    if (--m_transactionDepth > 0 || m_changedRows.isEmpty())
+        return;
+    QVector<int> rows;
+    QVector<int> roles;
+    rows.swap(m_changedRows);
+    roles.swap(m_changedRoles);
+    // empty roles mean all roles
+    if (m_allRolesChanged)
+        roles.clear();
+    m_allRolesChanged = false;
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    int first = rows.first();
+    for (int i = 1; i <= rows.size(); ++i)
+    {
+        if (i < rows.size() && rows.at(i) == rows.at(i - 1) + 1)
+            continue;
+        emit dataChanged(createIndex(first, 0), createIndex(rows.at(i - 1), 0),
+                         roles);
+        if (i < rows.size())
+            first = rows.at(i);
+    }
+}
+
+bool StringListModel::isInTransaction() const
+{
+    return m_transactionDepth > 0;
+}
+
+void StringListModel::notifyDataChanged(int row, const QVector<int> &roles)
+{
+    Q_ASSERT(row >= 0 && row < m_storage->size());
+    if (m_transactionDepth == 0)
+    {
+        const QModelIndex index = createIndex(row, 0);
+        emit dataChanged(index, index, roles);
+        return;
+    }
+    m_changedRows.append(row);
+    if (roles.isEmpty())
+        m_allRolesChanged = true;
+    if (m_allRolesChanged)
+        return;
+    for (int role : roles)
+    {
+        if (!m_changedRoles.contains(role))
+            m_changedRoles.append(role);
+    }
+}
+
+void StringListModel::shiftChangedRows(const QModelIndex &parent,
+                                       int first, int last)
+{
+    // rows remembered in transaction move down with inserted ones
+    if (parent.isValid())
+        return;
+    const int count = last - first + 1;
+    for (int &row : m_changedRows)
+    {
+        if (row >= first)
+            row += count;
+    }
 }
 
 QString StringListModel::operator[](int i) const
@@ -29,7 +186,10 @@ QModelIndex StringListModel::parent(const QModelIndex &child) const
 
 int StringListModel::rowCount(const QModelIndex &parent) const
 {
-    return 0;
+    // already implemented, fetchMore() and drainProducers() need it
+    if (parent.isValid())
+        return 0;
+    return m_storage->size();
 }
 
 int StringListModel::columnCount(const QModelIndex &parent) const
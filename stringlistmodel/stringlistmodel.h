@@ -2,7 +2,15 @@
 #define STRINGLISTMODEL_H
 
 #include <QAbstractItemModel>
+#include <QScopedPointer>
 #include <QStringList>
+#include <QTimer>
+
+#include <memory>
+
+#include "stringliststorage.h"
+#include "rowsource.h"
+#include "rowproducer.h"
 
 /**
  * @brief The StringListModel class
@@ -12,8 +20,51 @@ class StringListModel : public QAbstractItemModel
 {
 public:
     explicit StringListModel(QStringList data, QObject *parent = NULL);
+    /* Model over custom storage (see stringliststorage.h),
+     * takes ownership of storage.
+     */
+    explicit StringListModel(StringListStorage *storage, QObject *parent = NULL);
     ~StringListModel();
 
+    const StringListStorage *storage() const;
+
+    /* Rows can be loaded on demand instead of passing them
+     * to constructor. When view needs more rows, it calls fetchMore(),
+     * which appends up to pageSize rows from source.
+     * Takes ownership of source.
+     * Not part of koan, already implemented.
+     */
+    void setRowSource(RowSource *source, int pageSize = 256);
+    bool canFetchMore(const QModelIndex &parent) const;
+    void fetchMore(const QModelIndex &parent);
+
+    /* Handle to append rows from other threads.
+     * Rows are collected without locks and appended by model
+     * in its own thread at most once per DrainInterval ms,
+     * all of them as one insert (one rowsInserted()).
+     * Not part of koan, already implemented.
+     */
+    enum { DrainInterval = 16 };
+    RowProducer producer();
+    /* Append rows collected from producers right now.
+     */
+    void drainProducers();
+
+    /* Bulk edits. dataChanged() for rows changed between
+     * beginTransaction() and commitTransaction() is emitted
+     * on commit, once per contiguous range of changed rows
+     * (roles are union of all roles changed in transaction,
+     * empty if any change was reported with empty roles,
+     * which means all roles).
+     * Transactions can be nested, outermost commit emits.
+     * Rows inserted in transaction are taken into account:
+     * commit reports changed rows at their new positions.
+     * Not part of koan, already implemented.
+     */
+    void beginTransaction();
+    void commitTransaction();
+    bool isInTransaction() const;
+
     /* direct access to data (needed for test).
      * You don't want to provide such kind of methods
      * in your real models.
@@ -36,6 +87,8 @@ public:
     QModelIndex parent(const QModelIndex &child) const;
     /* Number of rows.
      * In our model number of rows is equal size of data.
+     * Already implemented, as rows inserted by fetchMore() and
+     * drainProducers() must be counted before koan is solved.
      * http://doc.qt.io/qt-5/qabstractitemmodel.html#rowCount
      */
     int rowCount(const QModelIndex &parent = QModelIndex()) const;
@@ -52,6 +105,9 @@ public:
     /* Set data for some role.
      * In our model Qt::DisplayRole is only used as role
      * and QString as type of value.
+     * Don't emit dataChanged() yourself, call
+     * notifyDataChanged(row, roles), so that changes made
+     * inside transaction are reported together.
      * http://doc.qt.io/qt-5/qabstractitemmodel.html#setData
      */
     bool setData(const QModelIndex &index, const QVariant &value, int role);
@@ -75,6 +131,38 @@ public slots:
      */
     void insert(int position, QString data);
     void insert(int position, QStringList data);
+
+protected:
+    /* Emits dataChanged() for row, or remembers row
+     * until commitTransaction() inside transaction.
+     */
+    void notifyDataChanged(int row, const QVector<int> &roles);
+
+private:
+    /* Keeps rows remembered in transaction pointing to the same
+     * data when rows are inserted before them (by fetchMore(),
+     * drainProducers() or insert()) until commit.
+     */
+    void shiftChangedRows(const QModelIndex &parent, int first, int last);
+
+    /* Rows of the model. Use m_storage->size(), m_storage->at(),
+     * m_storage->set() and m_storage->insert() to implement
+     * methods above.
+     * Call m_storage->insert() once per insert()/append()/prepend(),
+     * between beginInsertRows() and endInsertRows(), with the same
+     * position: storages like GapBufferStorage are fast for series
+     * of inserts only when they see them as they are, not row by row
+     * (see gapBufferModel test).
+     */
+    QScopedPointer<StringListStorage> m_storage;
+    QScopedPointer<RowSource> m_source;
+    int m_pageSize;
+    std::shared_ptr<RowQueue> m_queue;
+    QTimer m_drainTimer;
+    int m_transactionDepth;
+    QVector<int> m_changedRows;
+    QVector<int> m_changedRoles;
+    bool m_allRolesChanged;
 };
 
 #endif // STRINGLISTMODEL_H
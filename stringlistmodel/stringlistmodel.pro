@@ -11,7 +11,23 @@ CONFIG -= app_bundle
 TEMPLATE = app
 
 SOURCES += listmodelfromscratch.cpp \
-    stringlistmodel.cpp
+    stringlistmodel.cpp \
+    stringliststorage.cpp \
+    gapbufferstorage.cpp \
+    ropestorage.cpp \
+    mappedfilestorage.cpp \
+    compactstorage.cpp \
+    internedstorage.cpp \
+    rowsource.cpp \
+    rowproducer.cpp
 
 HEADERS += \
-    stringlistmodel.h
+    stringlistmodel.h \
+    stringliststorage.h \
+    gapbufferstorage.h \
+    ropestorage.h \
+    mappedfilestorage.h \
+    compactstorage.h \
+    internedstorage.h \
+    rowsource.h \
+    rowproducer.h
@@ -0,0 +1,67 @@
+#include "stringliststorage.h"
+
+StringListStorage::~StringListStorage()
+{}
+
+bool StringListStorage::isReadOnly() const
+{
+    return false;
+}
+
+bool StringListStorage::insert(int position, const QString &value)
+{
+    return insert(position, QStringList(value));
+}
+
+qint64 StringListStorage::memorySaved() const
+{
+    return 0;
+}
+
+qint64 StringListStorage::listRowCost(const QString &value)
+{
+    qint64 cost = sizeof(QString);
+    if (!value.isEmpty())
+        cost += sizeof(QArrayData) + (value.size() + 1) * sizeof(QChar);
+    return cost;
+}
+
+ListStorage::ListStorage(QStringList data)
+    : m_data(data)
+{}
+
+int ListStorage::size() const
+{
+    return m_data.size();
+}
+
+QString ListStorage::at(int i) const
+{
+    return m_data.at(i);
+}
+
+bool ListStorage::set(int i, const QString &value)
+{
+    m_data[i] = value;
+    return true;
+}
+
+bool ListStorage::insert(int position, const QStringList &values)
+{
+    if (position == m_data.size())
+    {
+        m_data.append(values);
+        return true;
+    }
+    QStringList tail = m_data.mid(position);
+    m_data.erase(m_data.begin() + position, m_data.end());
+    m_data.append(values);
+    m_data.append(tail);
+    return true;
+}
+
+bool ListStorage::insert(int position, const QString &value)
+{
+    m_data.insert(position, value);
+    return true;
+}
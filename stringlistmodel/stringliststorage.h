@@ -0,0 +1,81 @@
+#ifndef STRINGLISTSTORAGE_H
+#define STRINGLISTSTORAGE_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief The StringListStorage class
+ * is where StringListModel keeps its rows.
+ * Model itself only translates between indexes and rows
+ * and emits signals, so the way rows are stored can be changed
+ * for the workload (many inserts in the middle, huge lists,
+ * lists with repeating values) without touching the model.
+ */
+class StringListStorage
+{
+public:
+    virtual ~StringListStorage();
+
+    virtual int size() const = 0;
+    virtual QString at(int i) const = 0;
+
+    /**
+     * @brief isReadOnly if true, set() and insert() fail.
+     * @return
+     */
+    virtual bool isReadOnly() const;
+    /**
+     * @brief set replaces value of row i.
+     * @param i
+     * @param value
+     * @return false if storage is read only.
+     */
+    virtual bool set(int i, const QString &value) = 0;
+    /**
+     * @brief insert values, so that first of them has index position.
+     * position == 0 -> prepend, position == size() -> append.
+     * @param position
+     * @param values
+     * @return false if storage is read only.
+     */
+    virtual bool insert(int position, const QStringList &values) = 0;
+    virtual bool insert(int position, const QString &value);
+
+    /**
+     * @brief memorySaved bytes saved compared to keeping
+     * the same rows in ListStorage, 0 if storage doesn't know.
+     * @return
+     */
+    virtual qint64 memorySaved() const;
+
+protected:
+    /**
+     * @brief listRowCost approximate bytes row takes in QStringList:
+     * QString itself and its heap block of UTF-16 characters
+     * (empty strings share one static block).
+     */
+    static qint64 listRowCost(const QString &value);
+};
+
+/**
+ * @brief The ListStorage class
+ * default storage, just a QStringList.
+ * Every insert in the middle shifts the whole tail.
+ */
+class ListStorage : public StringListStorage
+{
+public:
+    explicit ListStorage(QStringList data = QStringList());
+
+    int size() const;
+    QString at(int i) const;
+    bool set(int i, const QString &value);
+    bool insert(int position, const QStringList &values);
+    bool insert(int position, const QString &value);
+
+private:
+    QStringList m_data;
+};
+
+#endif // STRINGLISTSTORAGE_H